@@ -22,6 +22,8 @@ int main(int argc, char* argv[]) {
     uint16_t port = 7777;
     size_t max_clients = 100;
     std::string db_conn = "host=localhost user=root password=admin dbname=gamedb";
+    std::string capture_file;
+    std::string replay_file;
     
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
@@ -32,12 +34,18 @@ int main(int argc, char* argv[]) {
             max_clients = std::stoull(argv[++i]);
         } else if (arg == "--db-conn" && i + 1 < argc) {
             db_conn = argv[++i];
+        } else if (arg == "--capture" && i + 1 < argc) {
+            capture_file = argv[++i];
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replay_file = argv[++i];
         } else if (arg == "--help") {
             std::cout << "Usage: " << argv[0] << " [options]\n"
                       << "Options:\n"
                       << "  --port <port>           Server port (default: 7777)\n"
                       << "  --max-clients <num>     Max simultaneous clients (default: 100)\n"
                       << "  --db-conn <connection>  Database connection string\n"
+                      << "  --capture <file>        Record inbound packets to a capture file\n"
+                      << "  --replay <file>         Replay a capture without sockets, then exit\n"
                       << "  --help                  Show this help\n";
             return 0;
         }
@@ -55,6 +63,8 @@ int main(int argc, char* argv[]) {
     
     // Cria e inicializa servidor
     g_server = std::make_unique<Server>(port, max_clients);
+    g_server->setCaptureFile(capture_file);
+    g_server->setReplayFile(replay_file);
     
     if (!g_server->initialize()) {
         Logger::error("Failed to initialize server");
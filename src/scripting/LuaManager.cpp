@@ -36,12 +36,28 @@ void LuaManager::registerBindings(Server* server) {
         "z", &Vector3::z
     );
     
+    // Bytes de pacote recebido, sem cópia. Indexável como o antigo vetor
+    // de bytes (data[1] é o byte de tipo, #data é o tamanho); só é válido
+    // durante o handler que o recebeu.
+    lua_.new_usertype<PacketBuffer>("PacketBuffer",
+        sol::meta_function::index, [](const PacketBuffer& buf, size_t i) -> sol::optional<uint8_t> {
+            if (i < 1 || i > buf.size()) return sol::nullopt;
+            return buf[i - 1];
+        },
+        sol::meta_function::length, &PacketBuffer::size,
+        "size", &PacketBuffer::size,
+        "to_string", [](const PacketBuffer& buf) {
+            return std::string(reinterpret_cast<const char*>(buf.data()), buf.size());
+        }
+    );
+
     lua_.new_usertype<Packet>("Packet",
         "peer_id", &Packet::peer_id,
         "type", &Packet::type,
-        "data", [](Packet& pkt) {
+        "data", [](const Packet& pkt) {
             return std::string(reinterpret_cast<const char*>(pkt.data.data()), pkt.data.size());
-        }
+        },
+        "bytes", [](const Packet& pkt) { return &pkt.data; }
     );
 
     lua_.new_usertype<Server>("Server",
@@ -92,18 +108,23 @@ void LuaManager::registerBindings(Server* server) {
     };
     
     // Network operations
+    // A string Lua é copiada uma vez, direto para o buffer do pacote
     lua_["send_packet"] = [server](uint32_t peer_id, const std::string& type, const std::string& data) {
         auto pkt_type = magic_enum::enum_cast<PacketType>(type); // Parse type string
-        std::vector<uint8_t> vec_data(data.begin(), data.end());
-        if (pkt_type.has_value()) {
-            return server->getNetworkManager()->sendPacket(peer_id, pkt_type.value(), vec_data);
+        if (!pkt_type.has_value()) {
+            return false;
         }
+        NetworkManager* network = server->getNetworkManager();
+        OutboundPacket packet = network->createPacket(pkt_type.value());
+        packet.writer().writeBytes(data.data(), data.size());
+        return network->sendPacket(peer_id, std::move(packet));
     };
     
     lua_["broadcast_packet"] = [server](const std::string& type, const std::string& data) {
-        PacketType pkt_type = PacketType::BROADCAST;
-        std::vector<uint8_t> vec_data(data.begin(), data.end());
-        return server->getNetworkManager()->broadcastPacket(pkt_type, vec_data);
+        NetworkManager* network = server->getNetworkManager();
+        OutboundPacket packet = network->createPacket(PacketType::BROADCAST);
+        packet.writer().writeBytes(data.data(), data.size());
+        return network->broadcastPacket(std::move(packet));
     };
 
     sol::table crypto_table = lua_.create_table();
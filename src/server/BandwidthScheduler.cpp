@@ -0,0 +1,52 @@
+// src/server/BandwidthScheduler.cpp
+#include "server/BandwidthScheduler.h"
+#include <algorithm>
+
+BandwidthScheduler::BandwidthScheduler(size_t bytes_per_second, float max_burst_seconds)
+    : bytes_per_second_(bytes_per_second), max_burst_seconds_(max_burst_seconds) {}
+
+float BandwidthScheduler::effectiveRate(const PeerLinkStats& link) const {
+    float rate = static_cast<float>(bytes_per_second_);
+
+    // O throttle da ENet já reflete congestionamento recente
+    rate *= static_cast<float>(link.packet_throttle) / static_cast<float>(ENET_PEER_PACKET_THROTTLE_SCALE);
+    rate *= 1.0f - std::clamp(link.packet_loss, 0.0f, 0.9f);
+
+    if (link.round_trip_time > kHighRoundTripMs) {
+        rate *= std::max(0.25f, static_cast<float>(kHighRoundTripMs) / link.round_trip_time);
+    }
+    return rate;
+}
+
+size_t BandwidthScheduler::budgetFor(uint32_t peer_id, const PeerLinkStats& link, float delta_time) {
+    PeerBucket& bucket = buckets_[peer_id];
+
+    float rate = effectiveRate(link);
+    float burst = std::max(rate * max_burst_seconds_, static_cast<float>(kMinSendBytes));
+    bucket.tokens = std::min(bucket.tokens + rate * delta_time, burst);
+
+    // O que a ENet ainda não enviou já ocupa o enlace
+    float available = bucket.tokens - static_cast<float>(link.queued_bytes);
+    if (available < static_cast<float>(kMinSendBytes)) {
+        return 0;
+    }
+    return static_cast<size_t>(available);
+}
+
+void BandwidthScheduler::consume(uint32_t peer_id, size_t bytes) {
+    auto it = buckets_.find(peer_id);
+    if (it != buckets_.end()) {
+        it->second.tokens = std::max(0.0f, it->second.tokens - static_cast<float>(bytes));
+    }
+}
+
+PeerLinkStats BandwidthScheduler::unknownLink() {
+    PeerLinkStats link;
+    link.packet_throttle = ENET_PEER_PACKET_THROTTLE_SCALE / 2;
+    link.round_trip_time = kHighRoundTripMs;
+    return link;
+}
+
+void BandwidthScheduler::removePeer(uint32_t peer_id) {
+    buckets_.erase(peer_id);
+}
@@ -0,0 +1,46 @@
+// include/server/BandwidthScheduler.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include "server/NetworkManager.h"
+
+// Orçamento de bytes de replicação por peer (token bucket).
+// A taxa base é reduzida conforme o throttle, a perda e o RTT que a ENet
+// mede para o enlace; o que ainda está na fila de saída da ENet é
+// descontado, para que snapshots não se acumulem num enlace ruim.
+class BandwidthScheduler {
+public:
+    BandwidthScheduler(size_t bytes_per_second, float max_burst_seconds);
+
+    // Orçamento disponível para o envio deste tick (0 = pular o peer)
+    size_t budgetFor(uint32_t peer_id, const PeerLinkStats& link, float delta_time);
+
+    // Desconta os bytes efetivamente enviados
+    void consume(uint32_t peer_id, size_t bytes);
+
+    void removePeer(uint32_t peer_id);
+
+    // Enlace presumido antes da primeira amostra da ENet (peer recém
+    // conectado): throttle pela metade e RTT alto, para que o snapshot
+    // inicial completo não saia sem orçamento
+    static PeerLinkStats unknownLink();
+
+private:
+    // Abaixo disto não vale a pena montar um snapshot
+    static constexpr size_t kMinSendBytes = 64;
+
+    // RTT a partir do qual a taxa passa a cair proporcionalmente
+    static constexpr uint32_t kHighRoundTripMs = 200;
+
+    struct PeerBucket {
+        float tokens = 0.0f;
+    };
+
+    float effectiveRate(const PeerLinkStats& link) const;
+
+    size_t bytes_per_second_;
+    float max_burst_seconds_;
+    std::unordered_map<uint32_t, PeerBucket> buckets_;
+};
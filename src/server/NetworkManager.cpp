@@ -1,156 +1,1288 @@
 // src/server/NetworkManager.cpp
 #include "server/NetworkManager.h"
+#include "server/RPCWire.h"
+#include "server/World.h"
 #include "utils/Logger.h"
+#include "utils/BinaryStream.h"
+#include "utils/PerformanceMonitor.h"
 #include <magic_enum/magic_enum.hpp>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <iterator>
 #include "NetworkManager.h"
 
-NetworkManager::NetworkManager(uint16_t port, size_t max_clients)
-    : host_(nullptr), port_(port), max_clients_(max_clients), next_peer_id_(1), rpc_handler_() {}
+#ifndef _WIN32
+#include <sys/socket.h>
+#endif
+
+// Timeout do enet_host_service na thread de I/O. Comandos de saída
+// enfileirados durante a espera aguardam no máximo isso.
+static constexpr uint32_t kIOServiceTimeoutMs = 1;
+
+static constexpr size_t kChannelCount = kChannelClassCount;
+
+// Canal usado para o peer: quem negociou menos canais (o par antigo
+// 0 confiável / 1 não confiável) recebe as classes extras nesse par
+static uint8_t peerChannel(const ENetPeer* peer, uint8_t channel) {
+    if (channel < peer->channelCount) {
+        return channel;
+    }
+    bool reliable = channel == channelFor(ChannelClass::RELIABLE_ORDERED) || channel == channelFor(ChannelClass::BULK);
+    uint8_t fallback = reliable ? channelFor(ChannelClass::RELIABLE_ORDERED)
+                                : channelFor(ChannelClass::UNRELIABLE_SEQUENCED);
+    return fallback < peer->channelCount ? fallback : 0;
+}
+
+// Intervalo de amostragem das estatísticas de enlace na thread de I/O
+static constexpr uint32_t kLinkStatsIntervalMs = 100;
+
+// Intervalo da telemetria na thread de simulação e peers listados no relatório
+static constexpr auto kTelemetryInterval = std::chrono::seconds(1);
+static constexpr size_t kTelemetryBusiestPeers = 5;
+
+// =============================================================
+// Canais
+// =============================================================
+uint32_t packetFlagsFor(ChannelClass cls) {
+    switch (cls) {
+        case ChannelClass::RELIABLE_ORDERED:
+        case ChannelClass::BULK:
+            return ENET_PACKET_FLAG_RELIABLE;
+        case ChannelClass::UNRELIABLE_SEQUENCED:
+            // Acima do MTU fragmenta sem virar confiável
+            return ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT;
+        default:
+            return ENET_PACKET_FLAG_UNSEQUENCED;
+    }
+}
+
+ChannelPolicy::ChannelPolicy() {
+    classes_.fill(ChannelClass::RELIABLE_ORDERED);
+    set(PacketType::PLAYER_MOVE, ChannelClass::UNRELIABLE_SEQUENCED);
+    set(PacketType::WORLD_STATE, ChannelClass::UNRELIABLE_SEQUENCED);
+    set(PacketType::SNAPSHOT_ACK, ChannelClass::UNSEQUENCED);
+    set(PacketType::BROADCAST, ChannelClass::UNSEQUENCED);
+}
+
+NetworkManager::NetworkManager(uint16_t port, size_t max_clients, const NetworkOptions& options)
+    : rpc_handler_(), port_(port), max_clients_(max_clients), options_(options),
+      packet_pool_(options.packet_pool_size), io_running_(false) {
+    if (options_.host_count == 0) {
+        options_.host_count = 1;
+    }
+    // No replay há um único shard sem host
+    if (!options_.replay_file.empty()) {
+        options_.host_count = 1;
+        options_.io_thread = false;
+    }
+    if (options_.host_count > 1 && !options_.io_thread) {
+        Logger::warning("Multiple ENet hosts require the I/O thread mode, enabling it");
+        options_.io_thread = true;
+    }
+}
 
 NetworkManager::~NetworkManager() {
     shutdown();
 }
 
-bool NetworkManager::initialize() {
+// Cria um host ENet cujo socket usa SO_REUSEPORT, para que vários hosts
+// escutem na mesma porta e o kernel distribua os clientes entre eles.
+// O host é criado sem endereço (socket não vinculado) e o socket é
+// trocado por um configurado como a ENet faria.
+static ENetHost* createReusePortHost(const ENetAddress& address, size_t peer_limit) {
+#ifdef SO_REUSEPORT
+    ENetHost* host = enet_host_create(nullptr, peer_limit, kChannelCount, 0, 0);
+    if (!host) {
+        return nullptr;
+    }
+
+    enet_socket_destroy(host->socket);
+    host->socket = enet_socket_create(ENET_SOCKET_TYPE_DATAGRAM);
+
+    int one = 1;
+    if (host->socket == ENET_SOCKET_NULL ||
+        setsockopt(host->socket, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) != 0 ||
+        enet_socket_bind(host->socket, &address) < 0) {
+        enet_host_destroy(host);
+        return nullptr;
+    }
+
+    enet_socket_set_option(host->socket, ENET_SOCKOPT_NONBLOCK, 1);
+    enet_socket_set_option(host->socket, ENET_SOCKOPT_BROADCAST, 1);
+    enet_socket_set_option(host->socket, ENET_SOCKOPT_RCVBUF, ENET_HOST_RECEIVE_BUFFER_SIZE);
+    enet_socket_set_option(host->socket, ENET_SOCKOPT_SNDBUF, ENET_HOST_SEND_BUFFER_SIZE);
+    host->address = address;
+    return host;
+#else
+    (void)address;
+    (void)peer_limit;
+    return nullptr;
+#endif
+}
+
+bool NetworkManager::createShardHost(HostShard& shard, size_t peer_limit) {
     ENetAddress address;
     address.host = ENET_HOST_ANY;
-    address.port = port_;
-    
+    address.port = shard.port;
+
+    if (options_.host_count > 1 && options_.reuse_port) {
+        shard.host = createReusePortHost(address, peer_limit);
+        if (shard.host) {
+            return true;
+        }
+        // Os hosts anteriores já estão na porta compartilhada; misturar com
+        // portas por host deixaria um layout que os clientes não conhecem
+        if (shard.index > 0) {
+            Logger::error("SO_REUSEPORT failed for host " + std::to_string(shard.index) +
+                          " after earlier hosts bound the shared port");
+            return false;
+        }
+        // Sem SO_REUSEPORT já no primeiro host: todos usam uma porta por host
+        options_.reuse_port = false;
+        Logger::warning("SO_REUSEPORT unavailable, hosts falling back to ports " + std::to_string(port_) +
+                        ".." + std::to_string(port_ + options_.host_count - 1));
+    }
+
     // Bandwidth: 0 = unlimited
-    host_ = enet_host_create(&address, max_clients_, 2, 0, 0);
-    
-    if (!host_) {
-        Logger::error("Failed to create ENet host");
+    shard.host = enet_host_create(&address, peer_limit, kChannelCount, 0, 0);
+    return shard.host != nullptr;
+}
+
+CompressionMode NetworkManager::compressionFor(size_t host_index) const {
+    if (options_.compression.size() == 1) {
+        return options_.compression[0];
+    }
+    return host_index < options_.compression.size() ? options_.compression[host_index] : CompressionMode::NONE;
+}
+
+bool NetworkManager::loadCompressionDictionary() {
+    if (options_.compression_dictionary.empty()) {
+        return true;
+    }
+
+    std::ifstream file(options_.compression_dictionary, std::ios::binary);
+    if (!file) {
+        Logger::error("Failed to open compression dictionary: " + options_.compression_dictionary);
         return false;
     }
-    
-    Logger::info("NetworkManager initialized on port " + std::to_string(port_));
+
+    auto dictionary = std::make_shared<std::vector<uint8_t>>(
+        std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    Logger::info("Loaded compression dictionary (" + std::to_string(dictionary->size()) + " bytes)");
+    compression_dictionary_ = std::move(dictionary);
     return true;
 }
 
+bool NetworkManager::initialize() {
+    size_t host_count = options_.host_count;
+    size_t peers_per_host = (max_clients_ + host_count - 1) / host_count;
+    peers_per_host_ = peers_per_host;
+
+    if (host_count * peers_per_host > peer_handle::kSlotMask) {
+        Logger::error("Too many peer slots: " + std::to_string(host_count * peers_per_host));
+        return false;
+    }
+
+    if (!options_.replay_file.empty()) {
+        replay_ = std::make_unique<PacketCaptureReader>();
+        if (!replay_->open(options_.replay_file)) {
+            replay_.reset();
+            return false;
+        }
+
+        // Os handles da captura podem vir de vários hosts: o shard
+        // único cobre todos os slots possíveis
+        auto shard = std::make_unique<HostShard>();
+        peers_per_host_ = peer_handle::kSlotMask;
+        shards_.push_back(std::move(shard));
+        Logger::info("NetworkManager replaying " + options_.replay_file + " (no sockets)");
+        return true;
+    }
+
+    if (!loadCompressionDictionary()) {
+        return false;
+    }
+
+    if (!options_.capture_file.empty() && !startCapture(options_.capture_file)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < host_count; ++i) {
+        auto shard = std::make_unique<HostShard>();
+        shard->index = i;
+        shard->slot_offset = i * peers_per_host;
+        shard->generations.assign(peers_per_host, 0);
+        shard->link_stats.resize(peers_per_host);
+        shard->port = options_.reuse_port ? port_ : static_cast<uint16_t>(port_ + i);
+
+        if (!createShardHost(*shard, peers_per_host)) {
+            Logger::error("Failed to create ENet host on port " + std::to_string(shard->port));
+            shards_.push_back(std::move(shard));
+            shutdown();
+            return false;
+        }
+
+        CompressionMode compression = compressionFor(i);
+        if (!installCompressor(shard->host, compression, options_.compression_level, compression_dictionary_)) {
+            Logger::error("Failed to enable " + std::string(magic_enum::enum_name(compression)) +
+                          " compression on host " + std::to_string(i));
+            shards_.push_back(std::move(shard));
+            shutdown();
+            return false;
+        }
+
+        if (options_.io_thread) {
+            shard->inbound_queue = std::make_unique<SpscQueue<Packet>>(options_.queue_capacity);
+            shard->outbound_queue = std::make_unique<MpscQueue<OutboundCommand>>(options_.queue_capacity);
+        }
+        shards_.push_back(std::move(shard));
+    }
+
+    if (options_.io_thread) {
+        io_running_ = true;
+        for (auto& shard : shards_) {
+            shard->thread = std::thread(&NetworkManager::ioThreadMain, this, std::ref(*shard));
+        }
+        Logger::info("Network I/O threads started: " + std::to_string(shards_.size()));
+    }
+
+    Logger::info("NetworkManager initialized on port " + std::to_string(port_) +
+                 " (" + std::to_string(host_count) + " host(s), " +
+                 std::to_string(peers_per_host) + " peers each)");
+    return true;
+}
+
+// O comando não será executado: destrói o pacote se ninguém mais o
+// referencia (um pacote de multicast vive até o RELEASE)
+static void discardCommand(const OutboundCommand& cmd) {
+    if (!cmd.packet) {
+        return;
+    }
+    if (cmd.kind == OutboundCommand::Kind::RELEASE) {
+        --cmd.packet->referenceCount;
+    }
+    if (cmd.packet->referenceCount == 0) {
+        enet_packet_destroy(cmd.packet);
+    }
+}
+
 void NetworkManager::shutdown() {
-    if (host_) {
-        enet_host_destroy(host_);
-        host_ = nullptr;
+    io_running_ = false;
+
+    for (auto& shard : shards_) {
+        if (shard->thread.joinable()) {
+            shard->thread.join();
+        }
+
+        if (shard->outbound_queue) {
+            // Pacotes que não chegaram a ser entregues à ENet
+            OutboundCommand cmd;
+            while (shard->outbound_queue->tryPop(cmd)) {
+                discardCommand(cmd);
+            }
+        }
+        if (shard->inbound_queue) {
+            Packet pkt;
+            while (shard->inbound_queue->tryPop(pkt)) {
+            }
+        }
+        shard->inbound_backlog.clear();
+    }
+    releasePackets();
+
+    for (auto& shard : shards_) {
+        if (shard->host) {
+            enet_host_destroy(shard->host);
+            shard->host = nullptr;
+        }
+    }
+    shards_.clear();
+    peers_.clear();
+    pending_batches_.clear();
+    stopCapture();
+    replay_.reset();
+}
+
+// =============================================================
+// Eventos
+// =============================================================
+// Handle do peer guardado em ENetPeer::data (0 = não conectado)
+static uint32_t peerHandle(const ENetPeer* peer) {
+    return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(peer->data));
+}
+
+bool NetworkManager::translateEvent(HostShard& shard, const ENetEvent& event, Packet& pkt) {
+    switch (event.type) {
+        case ENET_EVENT_TYPE_CONNECT: {
+            // O slot é a posição do peer no array do host; a geração
+            // distingue este ocupante dos anteriores
+            size_t local = static_cast<size_t>(event.peer - shard.host->peers);
+            uint16_t& generation = shard.generations[local];
+            generation = static_cast<uint16_t>(peer_handle::nextGeneration(generation));
+
+            uint32_t peer_id = peer_handle::make(static_cast<uint32_t>(shard.slot_offset + local), generation);
+            event.peer->data = reinterpret_cast<void*>(static_cast<uintptr_t>(peer_id));
+
+            pkt.type = PacketType::CONNECT;
+            pkt.peer_id = peer_id;
+            pkt.data.reset();
+            return true;
+        }
+
+        case ENET_EVENT_TYPE_DISCONNECT: {
+            uint32_t peer_id = peerHandle(event.peer);
+            if (peer_id == 0) {
+                return false;
+            }
+
+            pkt.type = PacketType::DISCONNECT;
+            pkt.peer_id = peer_id;
+            pkt.data.reset();
+
+            event.peer->data = nullptr;
+
+            if (options_.io_thread) {
+                std::lock_guard<std::mutex> lock(shard.link_stats_mutex);
+                shard.link_stats[event.peer - shard.host->peers].id = 0;
+            }
+            return true;
+        }
+
+        case ENET_EVENT_TYPE_RECEIVE: {
+            uint32_t peer_id = peerHandle(event.peer);
+            // Pacotes vazios são descartados (não têm nem o byte de tipo)
+            if (peer_id == 0 || event.packet->dataLength == 0) {
+                enet_packet_destroy(event.packet);
+                return false;
+            }
+
+            // CONNECT/DISCONNECT só vêm de eventos ENet; vindos de um
+            // cliente mexeriam no estado do peer na simulação
+            uint8_t cmd = event.packet->data[0];
+            if (cmd == static_cast<uint8_t>(PacketType::CONNECT) ||
+                cmd == static_cast<uint8_t>(PacketType::DISCONNECT)) {
+                Logger::warning("Dropping control packet type " + std::to_string(cmd) + " from peer " +
+                                std::to_string(peer_id));
+                enet_packet_destroy(event.packet);
+                return false;
+            }
+
+            pkt.peer_id = peer_id;
+
+            // DETECTA GODOT RPCs
+            if (cmd == 0x20) {
+                pkt.type = PacketType::NETWORK_COMMAND_REMOTE_CALL;
+            } else {
+                pkt.type = static_cast<PacketType>(cmd);
+            }
+
+            // Assume o ENetPacket sem copiar; liberado após o dispatch
+            pkt.data = PacketBuffer(event.packet);
+            return true;
+        }
+
+        default:
+            return false;
     }
 }
 
-std::vector<Packet> NetworkManager::pollEvents(uint32_t timeout_ms) {
-    std::vector<Packet> packets;
+void NetworkManager::trackPeer(const Packet& pkt, uint16_t shard_index) {
+    if (pkt.type == PacketType::CONNECT) {
+        SimPeer peer;
+        peer.shard = shard_index;
+        peers_.insert(pkt.peer_id, std::move(peer));
+    } else if (pkt.type == PacketType::DISCONNECT) {
+        peers_.erase(pkt.peer_id);
+    } else {
+        TrafficCounters& by_type = telemetry_.by_type[static_cast<uint8_t>(pkt.type)];
+        by_type.packets_in++;
+        by_type.bytes_in += pkt.data.size();
+
+        if (SimPeer* peer = peers_.find(pkt.peer_id)) {
+            peer->telemetry.traffic.packets_in++;
+            peer->telemetry.traffic.bytes_in += pkt.data.size();
+        }
+    }
+}
+
+void NetworkManager::acceptInbound(Packet&& pkt, uint16_t shard_index) {
+    if (pkt.type != PacketType::BATCH) {
+        trackPeer(pkt, shard_index);
+        inbound_packets_.push_back(std::move(pkt));
+        return;
+    }
+
+    // [BATCH]([varuint len][tipo][payload])...: cada mensagem vira um
+    // Packet próprio, como se tivesse chegado sozinha, apontando para o
+    // mesmo ENetPacket do envelope. Um tamanho inválido
+    // descarta o resto do envelope; mensagens de controle e envelopes
+    // aninhados são ignorados.
+    BinaryReader reader(pkt.data.data() + 1, pkt.data.size() - 1);
+    while (!reader.empty()) {
+        uint32_t len = 0;
+        const uint8_t* message = nullptr;
+        try {
+            len = reader.readVarUInt();
+            message = reader.readBytes(len);
+        } catch (const std::runtime_error& e) {
+            Logger::warning("Malformed BATCH from peer " + std::to_string(pkt.peer_id) + ": " + e.what());
+            break;
+        }
+
+        if (len == 0) {
+            continue;
+        }
+        auto type = static_cast<PacketType>(message[0]);
+        if (type == PacketType::CONNECT || type == PacketType::DISCONNECT || type == PacketType::BATCH) {
+            continue;
+        }
+
+        Packet inner;
+        inner.type = type;
+        inner.peer_id = pkt.peer_id;
+        inner.data = pkt.data.slice(static_cast<size_t>(message - pkt.data.data()), len);
+        trackPeer(inner, shard_index);
+        inbound_packets_.push_back(std::move(inner));
+    }
+}
+
+std::vector<Packet>& NetworkManager::pollEvents(uint32_t timeout_ms) {
+    releasePackets();
+
+    if (replay_) {
+        pollReplay();
+        return inbound_packets_;
+    }
+
+    if (options_.io_thread) {
+        Packet pkt;
+        for (auto& shard : shards_) {
+            while (shard->inbound_queue->tryPop(pkt)) {
+                acceptInbound(std::move(pkt), static_cast<uint16_t>(shard->index));
+            }
+        }
+    } else {
+        HostShard& shard = *shards_[0];
+        ENetEvent event;
+        while (enet_host_service(shard.host, &event, timeout_ms) > 0) {
+            Packet pkt;
+            if (translateEvent(shard, event, pkt)) {
+                acceptInbound(std::move(pkt), 0);
+            }
+        }
+    }
+
+    if (capture_.isOpen()) {
+        capturePackets();
+    }
+    return inbound_packets_;
+}
+
+void NetworkManager::releasePackets() {
+    inbound_packets_.clear();
+}
+
+std::vector<ENetSocket> NetworkManager::getPollSockets() const {
+    std::vector<ENetSocket> sockets;
+    if (options_.io_thread) {
+        return sockets;
+    }
+    for (const auto& shard : shards_) {
+        if (shard->host) {
+            sockets.push_back(shard->host->socket);
+        }
+    }
+    return sockets;
+}
+
+// =============================================================
+// Captura e replay
+// =============================================================
+bool NetworkManager::startCapture(const std::string& path) {
+    if (replay_) {
+        Logger::error("Cannot capture packets while replaying");
+        return false;
+    }
+    // Ligada em execução: conta os ticks a partir de agora, não do início
+    return capture_.open(path, sim_tick_ - 1);
+}
+
+void NetworkManager::stopCapture() {
+    capture_.close();
+}
+
+void NetworkManager::capturePackets() {
+    // Grava na ordem em que a simulação vê os pacotes (já intercalados
+    // entre os shards), que é a ordem que o replay precisa reproduzir
+    for (const Packet& pkt : inbound_packets_) {
+        capture_.record(sim_tick_, pkt.peer_id, pkt.type, pkt.data.data(), pkt.data.size());
+    }
+}
+
+void NetworkManager::pollReplay() {
+    // Os ticks da captura começam em 1, como sim_tick_
+    uint64_t tick;
+    CaptureRecord record;
+    while (replay_->peekTick(tick) && tick <= sim_tick_ && replay_->next(record)) {
+        Packet pkt;
+        pkt.type = record.type;
+        pkt.peer_id = record.peer_id;
+        if (record.size > 0) {
+            pkt.data = PacketBuffer(enet_packet_create(record.data, record.size, 0));
+        }
+        trackPeer(pkt, 0);
+        inbound_packets_.push_back(std::move(pkt));
+    }
+}
+
+// =============================================================
+// Threads de I/O (uma por host)
+// =============================================================
+void NetworkManager::pushInbound(HostShard& shard, Packet&& pkt) {
+    // Preserva a ordem: enquanto houver backlog, tudo passa por ele
+    if (shard.inbound_backlog.empty() && shard.inbound_queue->tryPush(std::move(pkt))) {
+        return;
+    }
+    if (shard.inbound_backlog.empty()) {
+        Logger::warning("Network inbound queue full on host " + std::to_string(shard.index) +
+                        ", buffering on I/O thread");
+    }
+    shard.inbound_backlog.push_back(std::move(pkt));
+}
+
+void NetworkManager::drainOutbound(HostShard& shard) {
+    OutboundCommand cmd;
+    while (shard.outbound_queue->tryPop(cmd)) {
+        executeCommand(shard, cmd);
+    }
+}
+
+void NetworkManager::ioThreadMain(HostShard& shard) {
     ENetEvent event;
-    
-    while (enet_host_service(host_, &event, timeout_ms) > 0) {
-        switch (event.type) {
-            case ENET_EVENT_TYPE_CONNECT: {
-                uint32_t peer_id = next_peer_id_++;
-                peer_to_id_[event.peer] = peer_id;
-                id_to_peer_[peer_id] = event.peer;
-                
-                Packet pkt;
-                pkt.type = PacketType::CONNECT;
-                pkt.peer_id = peer_id;
-                packets.push_back(pkt);
-                break;
-            }
-            
-            case ENET_EVENT_TYPE_DISCONNECT: {
-                auto it = peer_to_id_.find(event.peer);
-                if (it != peer_to_id_.end()) {
-                    Packet pkt;
-                    pkt.type = PacketType::DISCONNECT;
-                    pkt.peer_id = it->second;
-                    packets.push_back(pkt);
-                    
-                    id_to_peer_.erase(it->second);
-                    peer_to_id_.erase(it);
+
+    while (io_running_.load(std::memory_order_relaxed)) {
+        bool delivered = false;
+
+        // Entrega o que ficou represado com a fila de entrada cheia
+        while (!shard.inbound_backlog.empty() &&
+               shard.inbound_queue->tryPush(std::move(shard.inbound_backlog.front()))) {
+            shard.inbound_backlog.pop_front();
+            delivered = true;
+        }
+
+        drainOutbound(shard);
+
+        int rc = enet_host_service(shard.host, &event, kIOServiceTimeoutMs);
+        while (rc > 0) {
+            Packet pkt;
+            if (translateEvent(shard, event, pkt)) {
+                pushInbound(shard, std::move(pkt));
+                delivered = true;
+            }
+            rc = enet_host_check_events(shard.host, &event);
+        }
+
+        // Acorda a simulação para processar a entrada já, não no próximo tick
+        if (delivered && inbound_notifier_) {
+            inbound_notifier_();
+        }
+
+        // Envia imediatamente o que chegou durante a espera
+        drainOutbound(shard);
+        enet_host_flush(shard.host);
+
+        uint32_t now = enet_time_get();
+        if (now - shard.last_link_sample >= kLinkStatsIntervalMs) {
+            shard.last_link_sample = now;
+            sampleLinkStats(shard);
+        }
+    }
+}
+
+// =============================================================
+// Estatísticas de enlace
+// =============================================================
+// Soma os bytes na fila, separando comandos confiáveis (que pedem ACK)
+static void addQueuedBytes(ENetList& commands, size_t& reliable, size_t& unreliable) {
+    for (ENetListIterator it = enet_list_begin(&commands); it != enet_list_end(&commands);
+         it = enet_list_next(it)) {
+        const auto* command = reinterpret_cast<ENetOutgoingCommand*>(it);
+        if (command->command.header.command & ENET_PROTOCOL_COMMAND_FLAG_ACKNOWLEDGE) {
+            reliable += command->fragmentLength;
+        } else {
+            unreliable += command->fragmentLength;
+        }
+    }
+}
+
+static PeerLinkStats readLinkStats(ENetPeer* peer) {
+    PeerLinkStats stats;
+    stats.round_trip_time = peer->roundTripTime;
+    stats.round_trip_time_variance = peer->roundTripTimeVariance;
+    stats.packet_throttle = peer->packetThrottle;
+    stats.packet_loss = static_cast<float>(peer->packetLoss) / static_cast<float>(ENET_PEER_PACKET_LOSS_SCALE);
+    addQueuedBytes(peer->outgoingCommands, stats.queued_reliable_bytes, stats.queued_unreliable_bytes);
+    addQueuedBytes(peer->outgoingSendReliableCommands, stats.queued_reliable_bytes, stats.queued_unreliable_bytes);
+    stats.queued_bytes = stats.queued_reliable_bytes + stats.queued_unreliable_bytes;
+    stats.reliable_in_transit = peer->reliableDataInTransit;
+    return stats;
+}
+
+void NetworkManager::sampleLinkStats(HostShard& shard) {
+    std::lock_guard<std::mutex> lock(shard.link_stats_mutex);
+    for (size_t i = 0; i < shard.host->peerCount; ++i) {
+        ENetPeer* peer = &shard.host->peers[i];
+        HostShard::LinkSample& sample = shard.link_stats[i];
+        sample.id = peerHandle(peer);
+        if (sample.id != 0) {
+            sample.stats = readLinkStats(peer);
+        }
+    }
+}
+
+bool NetworkManager::getPeerLinkStats(uint32_t peer_id, PeerLinkStats& out) {
+    HostShard* shard = findShard(peer_id);
+    if (!shard) {
+        return false;
+    }
+
+    // Sem thread de I/O os peers são lidos diretamente
+    if (!options_.io_thread) {
+        ENetPeer* peer = resolvePeer(*shard, peer_id);
+        if (!peer) {
+            return false;
+        }
+        out = readLinkStats(peer);
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(shard->link_stats_mutex);
+    const HostShard::LinkSample& sample = shard->link_stats[peer_handle::slot(peer_id) - shard->slot_offset];
+    if (sample.id != peer_id) {
+        return false;
+    }
+    out = sample.stats;
+    return true;
+}
+
+// =============================================================
+// Envio
+// =============================================================
+void NetworkManager::executeCommand(HostShard& shard, const OutboundCommand& cmd) {
+    switch (cmd.kind) {
+        case OutboundCommand::Kind::SEND: {
+            ENetPeer* peer = resolvePeer(shard, cmd.peer_id);
+            bool sent = peer && enet_peer_send(peer, peerChannel(peer, cmd.channel), cmd.packet) == 0;
+            if (peer && !sent) {
+                send_failures_.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (!sent) {
+                // Peer desconectou antes do envio: a ENet não assumiu o pacote
+                if (cmd.packet->referenceCount == 0) {
+                    enet_packet_destroy(cmd.packet);
                 }
-                break;
-            }
-            
-            case ENET_EVENT_TYPE_RECEIVE: {
-                auto it = peer_to_id_.find(event.peer);
-                if (it != peer_to_id_.end()) {
-                    Packet pkt;
-                    pkt.peer_id = it->second;
-
-                    // DETECTA GODOT RPCs
-                    if (event.packet->dataLength > 0) {
-                        uint8_t cmd = event.packet->data[0];
-                        if (cmd == 0x20) {
-                            pkt.type = PacketType::NETWORK_COMMAND_REMOTE_CALL;
-                        } else {
-                            pkt.type = static_cast<PacketType>(cmd);
-                        }
-                    } else {
-                        pkt.type = PacketType::DISCONNECT; // fallback
-                    }
-
-                    pkt.data.assign(event.packet->data, event.packet->data + event.packet->dataLength);
-                    packets.push_back(std::move(pkt));
+            }
+            break;
+        }
+
+        case OutboundCommand::Kind::BROADCAST: {
+            for (size_t i = 0; i < shard.host->peerCount; ++i) {
+                ENetPeer* peer = &shard.host->peers[i];
+                uint32_t id = peerHandle(peer);
+                if (id != 0 && id != cmd.peer_id &&
+                    enet_peer_send(peer, peerChannel(peer, cmd.channel), cmd.packet) != 0) {
+                    send_failures_.fetch_add(1, std::memory_order_relaxed);
                 }
-                enet_packet_destroy(event.packet);
-                break;
             }
+            // Nenhum destinatário: a ENet não assumiu o pacote
+            if (cmd.packet->referenceCount == 0) {
+                enet_packet_destroy(cmd.packet);
+            }
+            break;
+        }
 
-            default:
-                break;
+        case OutboundCommand::Kind::DISCONNECT: {
+            if (ENetPeer* peer = resolvePeer(shard, cmd.peer_id)) {
+                enet_peer_disconnect(peer, 0);
+            }
+            break;
         }
+
+        case OutboundCommand::Kind::RELEASE: {
+            if (--cmd.packet->referenceCount == 0) {
+                enet_packet_destroy(cmd.packet);
+            }
+            break;
+        }
+    }
+}
+
+void NetworkManager::submitCommand(HostShard& shard, OutboundCommand&& cmd) {
+    // Replay: o pacote foi montado (custo medido) mas não há para onde enviar
+    if (!shard.host) {
+        discardCommand(cmd);
+        return;
+    }
+
+    if (!options_.io_thread) {
+        executeCommand(shard, cmd);
+        return;
+    }
+
+    // Fila cheia: espera a thread de I/O abrir espaço em vez de descartar
+    while (!shard.outbound_queue->tryPush(std::move(cmd))) {
+        if (!io_running_.load(std::memory_order_relaxed)) {
+            discardCommand(cmd);
+            return;
+        }
+        std::this_thread::yield();
     }
-    
-    return packets;
 }
 
-bool NetworkManager::sendPacket(uint32_t peer_id, PacketType type, 
-                                const std::vector<uint8_t>& data, bool reliable) {
-    auto it = id_to_peer_.find(peer_id);
-    if (it == id_to_peer_.end()) {
+NetworkManager::HostShard* NetworkManager::findShard(uint32_t peer_id) {
+    const SimPeer* peer = peers_.find(peer_id);
+    return peer ? shards_[peer->shard].get() : nullptr;
+}
+
+ENetPeer* NetworkManager::resolvePeer(HostShard& shard, uint32_t peer_id) const {
+    size_t slot = peer_handle::slot(peer_id);
+    if (!shard.host || slot < shard.slot_offset || slot - shard.slot_offset >= shard.host->peerCount) {
+        return nullptr;
+    }
+    ENetPeer* peer = &shard.host->peers[slot - shard.slot_offset];
+    return peerHandle(peer) == peer_id ? peer : nullptr;
+}
+
+void NetworkManager::enqueueSend(HostShard& shard, uint32_t peer_id, ChannelClass cls, ENetPacket* packet) {
+    OutboundCommand cmd;
+    cmd.kind = OutboundCommand::Kind::SEND;
+    cmd.channel = channelFor(cls);
+    cmd.peer_id = peer_id;
+    cmd.packet = packet;
+    submitCommand(shard, std::move(cmd));
+}
+
+void NetworkManager::emitBatch(HostShard& shard, uint32_t peer_id, OutboundBatch& batch, ChannelClass cls) {
+    if (batch.count == 0) {
+        return;
+    }
+
+    // O buffer do lote vai para a ENet sem cópia; uma mensagem só vai
+    // sem o envelope BATCH
+    size_t offset = batch.count == 1 ? batch.first_offset : 0;
+    enqueueSend(shard, peer_id, cls, PacketPool::wrap(batch.buffer, offset, packetFlagsFor(cls)));
+
+    batch.buffer.reset();
+    batch.count = 0;
+}
+
+void NetworkManager::flushPeer(uint32_t peer_id, SimPeer& peer) {
+    peer.batches.pending = false;
+
+    HostShard& shard = *shards_[peer.shard];
+    for (size_t i = 0; i < kChannelClassCount; ++i) {
+        emitBatch(shard, peer_id, peer.batches.by_class[i], static_cast<ChannelClass>(i));
+    }
+    emitBatch(shard, peer_id, peer.batches.rpc,
+              options_.channels.classFor(PacketType::NETWORK_COMMAND_REMOTE_CALL));
+}
+
+void NetworkManager::flush() {
+    for (uint32_t peer_id : pending_batches_) {
+        // Peers que desconectaram no meio do tick já saíram da tabela
+        SimPeer* peer = peers_.find(peer_id);
+        if (peer && peer->batches.pending) {
+            flushPeer(peer_id, *peer);
+        }
+    }
+    pending_batches_.clear();
+
+    // Uma vez por flush em vez de uma por destinatário
+    if (unreported_sent_ > 0) {
+        PerformanceMonitor::getInstance().recordPacketSent(unreported_sent_);
+        unreported_sent_ = 0;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_telemetry_sample_ >= kTelemetryInterval) {
+        sampleTelemetry();
+    }
+
+    // No modo com threads cada thread de I/O dá flush após drenar a fila
+    if (!options_.io_thread) {
+        for (auto& shard : shards_) {
+            if (shard->host) {
+                enet_host_flush(shard->host);
+            }
+        }
+    }
+}
+
+bool NetworkManager::appendToBatch(uint32_t peer_id, SimPeer& peer, PacketType type,
+                                   std::span<const uint8_t> payload, ChannelClass cls) {
+    HostShard& shard = *shards_[peer.shard];
+    PeerBatches& batches = peer.batches;
+    OutboundBatch& batch = batches.by_class[static_cast<size_t>(cls)];
+
+    size_t message_size = 1 + payload.size();
+    size_t framed_size = varUIntSize(message_size) + message_size;
+
+    // RPCs Godot são interpretados pelo cliente Godot e não podem ir em lote
+    bool batchable = options_.batching && type != PacketType::NETWORK_COMMAND_REMOTE_CALL &&
+                     cls != ChannelClass::BULK && 1 + framed_size <= options_.batch_size;
+
+    if (!batchable) {
+        // Mantém a ordem: o que já está no lote sai antes (e, para RPCs,
+        // também os RPCs enfileirados)
+        emitBatch(shard, peer_id, batch, cls);
+        if (type == PacketType::NETWORK_COMMAND_REMOTE_CALL) {
+            emitBatch(shard, peer_id, batches.rpc,
+                      options_.channels.classFor(PacketType::NETWORK_COMMAND_REMOTE_CALL));
+        }
         return false;
     }
-    
-    std::vector<uint8_t> packet_data;
-    packet_data.push_back(static_cast<uint8_t>(type));
-    packet_data.insert(packet_data.end(), data.begin(), data.end());
-    
-    uint32_t flags = reliable ? ENET_PACKET_FLAG_RELIABLE : ENET_PACKET_FLAG_UNSEQUENCED;
-    ENetPacket* packet = enet_packet_create(packet_data.data(), packet_data.size(), flags);
-    
-    return enet_peer_send(it->second, 0, packet) == 0;
+
+    // Não cabe no lote atual: envia o lote e começa outro
+    if (batch.count > 0 && batch.buffer->bytes.size() + framed_size > options_.batch_size) {
+        emitBatch(shard, peer_id, batch, cls);
+    }
+
+    if (batch.count == 0) {
+        batch.buffer = packet_pool_.acquire();
+        batch.buffer->bytes.push_back(static_cast<uint8_t>(PacketType::BATCH));
+    }
+
+    countOutbound(peer, type, message_size);
+
+    BinaryWriter writer(batch.buffer->bytes);
+    writer.writeVarUInt(static_cast<uint32_t>(message_size));
+    if (batch.count == 0) {
+        batch.first_offset = writer.size();
+    }
+    writer.writeU8(static_cast<uint8_t>(type));
+    writer.writeBytes(payload.data(), payload.size());
+    ++batch.count;
+
+    if (!batches.pending) {
+        batches.pending = true;
+        pending_batches_.push_back(peer_id);
+    }
+    return true;
 }
 
-bool NetworkManager::broadcastPacket(PacketType type, const std::vector<uint8_t>& data, 
-                                    uint32_t exclude_peer) {
-    std::vector<uint8_t> packet_data;
-    packet_data.push_back(static_cast<uint8_t>(type));
-    packet_data.insert(packet_data.end(), data.begin(), data.end());
-    
-    ENetPacket* packet = enet_packet_create(packet_data.data(), packet_data.size(), 
-                                            ENET_PACKET_FLAG_UNSEQUENCED);
-    
-    for (const auto& [id, peer] : id_to_peer_) {
+void NetworkManager::sendBuffer(uint32_t peer_id, SimPeer& peer, PooledBufferPtr buffer, ChannelClass cls) {
+    countOutbound(peer, static_cast<PacketType>(buffer->bytes[0]), buffer->bytes.size());
+    enqueueSend(*shards_[peer.shard], peer_id, cls, PacketPool::wrap(buffer, 0, packetFlagsFor(cls)));
+}
+
+bool NetworkManager::sendPacket(uint32_t peer_id, PacketType type, const std::vector<uint8_t>& data) {
+    return sendPacket(peer_id, type, data, options_.channels.classFor(type));
+}
+
+bool NetworkManager::sendPacket(uint32_t peer_id, PacketType type,
+                                const std::vector<uint8_t>& data, ChannelClass cls) {
+    SimPeer* peer = peers_.find(peer_id);
+    if (!peer) {
+        return false;
+    }
+
+    if (appendToBatch(peer_id, *peer, type, data, cls)) {
+        return true;
+    }
+
+    // Fora de lote: uma única cópia, para o buffer que a ENet vai usar
+    OutboundPacket packet = createPacket(type);
+    packet.writer().writeBytes(data.data(), data.size());
+    sendBuffer(peer_id, *peer, packet.release(), cls);
+    return true;
+}
+
+bool NetworkManager::sendPacket(uint32_t peer_id, OutboundPacket&& packet) {
+    ChannelClass cls = options_.channels.classFor(packet.type());
+    return sendPacket(peer_id, std::move(packet), cls);
+}
+
+bool NetworkManager::sendPacket(uint32_t peer_id, OutboundPacket&& packet, ChannelClass cls) {
+    SimPeer* peer = peers_.find(peer_id);
+    if (!peer || !packet.valid()) {
+        return false;
+    }
+
+    // Em lote a mensagem é copiada para o buffer do lote e o do pacote
+    // volta ao pool quando packet sai de escopo
+    if (appendToBatch(peer_id, *peer, packet.type(), packet.payload(), cls)) {
+        return true;
+    }
+
+    sendBuffer(peer_id, *peer, packet.release(), cls);
+    return true;
+}
+
+void NetworkManager::broadcastBuffer(PooledBufferPtr buffer, PacketType type, uint32_t exclude_peer) {
+    ChannelClass cls = options_.channels.classFor(type);
+
+    // Conta uma entrega por peer conectado, como se fosse unicast
+    for (auto& [id, peer] : peers_) {
         if (id != exclude_peer) {
-            enet_peer_send(peer, 0, packet);
+            countOutbound(peer, type, buffer->bytes.size());
+        }
+    }
+
+    // Um ENetPacket por shard (o referenceCount não é atômico e cada
+    // thread de I/O mexe no seu), todos sobre o mesmo buffer
+    for (auto& shard : shards_) {
+        OutboundCommand cmd;
+        cmd.kind = OutboundCommand::Kind::BROADCAST;
+        cmd.channel = channelFor(cls);
+        cmd.peer_id = exclude_peer;
+        cmd.packet = PacketPool::wrap(buffer, 0, packetFlagsFor(cls));
+        submitCommand(*shard, std::move(cmd));
+    }
+}
+
+bool NetworkManager::broadcastPacket(PacketType type, const std::vector<uint8_t>& data,
+                                    uint32_t exclude_peer) {
+    OutboundPacket packet = createPacket(type);
+    packet.writer().writeBytes(data.data(), data.size());
+    broadcastBuffer(packet.release(), type, exclude_peer);
+    return true;
+}
+
+bool NetworkManager::broadcastPacket(OutboundPacket&& packet, uint32_t exclude_peer) {
+    if (!packet.valid()) {
+        return false;
+    }
+    PacketType type = packet.type();
+    broadcastBuffer(packet.release(), type, exclude_peer);
+    return true;
+}
+
+size_t NetworkManager::multicastBuffer(PooledBufferPtr buffer, std::span<const uint32_t> peer_ids,
+                                       ChannelClass cls) {
+    PacketType type = static_cast<PacketType>(buffer->bytes[0]);
+    std::span<const uint8_t> payload(buffer->bytes.data() + 1, buffer->bytes.size() - 1);
+
+    // Um ENetPacket por shard (ver broadcastBuffer), criado para o primeiro
+    // destinatário do shard e compartilhado pelos demais. A referência
+    // extra impede que um SEND que falhe ou termine antes dos outros o
+    // destrua; o RELEASE no fim a solta.
+    multicast_packets_.assign(shards_.size(), nullptr);
+
+    size_t recipients = 0;
+    for (uint32_t peer_id : peer_ids) {
+        SimPeer* peer = peers_.find(peer_id);
+        if (!peer) {
+            continue;
         }
+        ++recipients;
+
+        // Mensagens pequenas vão em lote, como em sendPacket
+        if (appendToBatch(peer_id, *peer, type, payload, cls)) {
+            continue;
+        }
+
+        ENetPacket*& packet = multicast_packets_[peer->shard];
+        if (!packet) {
+            packet = PacketPool::wrap(buffer, 0, packetFlagsFor(cls));
+            ++packet->referenceCount;
+        }
+        countOutbound(*peer, type, buffer->bytes.size());
+        enqueueSend(*shards_[peer->shard], peer_id, cls, packet);
+    }
+
+    for (size_t i = 0; i < multicast_packets_.size(); ++i) {
+        if (multicast_packets_[i]) {
+            OutboundCommand cmd;
+            cmd.kind = OutboundCommand::Kind::RELEASE;
+            cmd.packet = multicast_packets_[i];
+            submitCommand(*shards_[i], std::move(cmd));
+        }
+    }
+    return recipients;
+}
+
+size_t NetworkManager::multicastPacket(OutboundPacket&& packet, std::span<const uint32_t> peer_ids) {
+    if (!packet.valid()) {
+        return 0;
+    }
+    ChannelClass cls = options_.channels.classFor(packet.type());
+    return multicastBuffer(packet.release(), peer_ids, cls);
+}
+
+// =============================================================
+// RPCs Godot
+// =============================================================
+OutboundPacket NetworkManager::createRPCPacket(uint32_t node_id, uint16_t method_id,
+                                               std::span<const Variant> args) {
+    OutboundPacket packet = createPacket(PacketType::NETWORK_COMMAND_REMOTE_CALL);
+    BinaryWriter writer = packet.writer();
+    if (!rpc_wire::writeCall(writer, node_id, method_id, args)) {
+        Logger::error("RPC " + std::to_string(method_id) + " has too many args: " + std::to_string(args.size()));
+        return OutboundPacket();
+    }
+    return packet;
+}
+
+bool NetworkManager::sendRPC(uint32_t peer_id, uint32_t node_id, uint16_t method_id,
+                             std::span<const Variant> args) {
+    if (!peers_.contains(peer_id)) {
+        return false;
+    }
+    return sendPacket(peer_id, createRPCPacket(node_id, method_id, args));
+}
+
+size_t NetworkManager::multicastRPC(std::span<const uint32_t> peer_ids, uint32_t node_id, uint16_t method_id,
+                                    std::span<const Variant> args) {
+    if (peer_ids.empty()) {
+        return 0;
+    }
+    return multicastPacket(createRPCPacket(node_id, method_id, args), peer_ids);
+}
+
+// Monta [0x20][chamada] em rpc_call_scratch_
+bool NetworkManager::encodeRPCCall(uint32_t node_id, uint16_t method_id, std::span<const Variant> args) {
+    rpc_call_scratch_.clear();
+    BinaryWriter writer(rpc_call_scratch_);
+    writer.writeU8(static_cast<uint8_t>(PacketType::NETWORK_COMMAND_REMOTE_CALL));
+    if (!rpc_wire::writeCall(writer, node_id, method_id, args)) {
+        Logger::error("RPC " + std::to_string(method_id) + " has too many args: " + std::to_string(args.size()));
+        return false;
     }
-    
     return true;
 }
 
-// void NetworkManager::sendRPC(uint32_t peer_id, const std::string &node_path, const std::string &method, const std::vector<Variant> &args, bool reliable)
-// {
-// auto payload = rpc_handler_. buildGodotRPCPacket(node_path, method, args);
-// std::vector<uint8_t> pkt;
-// pkt.push_back(static_cast<uint8_t>(PacketType::RPC_CALL));
-// pkt.insert(pkt.end(), payload.begin(), payload.end());
-// sendPacket(peer_id, PacketType::RPC_CALL, std::vector<uint8_t>(payload.begin(), payload.end()), reliable);
-// }
+// Mesmo esquema de appendToBatch, com o envelope 0x21 que o cliente Godot
+// reconhece; emitBatch envia uma chamada sozinha sem o envelope
+void NetworkManager::appendToRPCBatch(uint32_t peer_id, SimPeer& peer, std::span<const uint8_t> call) {
+    OutboundBatch& batch = peer.batches.rpc;
+    size_t framed_size = varUIntSize(call.size()) + call.size();
+
+    if (batch.count > 0 && batch.buffer->bytes.size() + framed_size > options_.batch_size) {
+        emitBatch(*shards_[peer.shard], peer_id, batch,
+                  options_.channels.classFor(PacketType::NETWORK_COMMAND_REMOTE_CALL));
+    }
+
+    if (batch.count == 0) {
+        batch.buffer = packet_pool_.acquire();
+        batch.buffer->bytes.push_back(static_cast<uint8_t>(PacketType::NETWORK_COMMAND_REMOTE_CALL_BATCH));
+    }
+
+    countOutbound(peer, PacketType::NETWORK_COMMAND_REMOTE_CALL, call.size());
+
+    BinaryWriter writer(batch.buffer->bytes);
+    writer.writeVarUInt(static_cast<uint32_t>(call.size()));
+    if (batch.count == 0) {
+        batch.first_offset = writer.size();
+    }
+    writer.writeBytes(call.data(), call.size());
+    ++batch.count;
+
+    if (!peer.batches.pending) {
+        peer.batches.pending = true;
+        pending_batches_.push_back(peer_id);
+    }
+}
+
+bool NetworkManager::queueRPC(uint32_t peer_id, uint32_t node_id, uint16_t method_id,
+                              std::span<const Variant> args) {
+    SimPeer* peer = peers_.find(peer_id);
+    if (!peer || !encodeRPCCall(node_id, method_id, args)) {
+        return false;
+    }
+    appendToRPCBatch(peer_id, *peer, rpc_call_scratch_);
+    return true;
+}
+
+size_t NetworkManager::queueRPC(std::span<const uint32_t> peer_ids, uint32_t node_id, uint16_t method_id,
+                                std::span<const Variant> args) {
+    if (peer_ids.empty() || !encodeRPCCall(node_id, method_id, args)) {
+        return 0;
+    }
+
+    size_t recipients = 0;
+    for (uint32_t peer_id : peer_ids) {
+        if (SimPeer* peer = peers_.find(peer_id)) {
+            appendToRPCBatch(peer_id, *peer, rpc_call_scratch_);
+            ++recipients;
+        }
+    }
+    return recipients;
+}
+
+size_t NetworkManager::sendRPCNear(SpatialGrid& grid, float x, float z, float radius, uint32_t node_id,
+                                   uint16_t method_id, std::span<const Variant> args, uint32_t exclude_peer) {
+    grid.queryRadiusInto(x, z, radius, near_peers_);
+    if (exclude_peer != 0) {
+        std::erase(near_peers_, exclude_peer);
+    }
+    return multicastRPC(near_peers_, node_id, method_id, args);
+}
+
+// =============================================================
+// Telemetria
+// =============================================================
+void NetworkManager::countOutbound(SimPeer& peer, PacketType type, size_t bytes) {
+    TrafficCounters& by_type = telemetry_.by_type[static_cast<uint8_t>(type)];
+    by_type.packets_out++;
+    by_type.bytes_out += bytes;
+
+    peer.telemetry.traffic.packets_out++;
+    peer.telemetry.traffic.bytes_out += bytes;
+    ++unreported_sent_;
+}
+
+void NetworkManager::sampleTelemetry() {
+    auto now = std::chrono::steady_clock::now();
+    float elapsed = last_telemetry_sample_ == std::chrono::steady_clock::time_point{}
+                        ? 0.0f
+                        : std::chrono::duration<float>(now - last_telemetry_sample_).count();
+    last_telemetry_sample_ = now;
+
+    NetworkTelemetry& t = telemetry_;
+    t.peers = peers_.size();
+    t.rtt_min = t.peers > 0 ? UINT32_MAX : 0;
+    t.rtt_max = 0;
+    t.throttle_min = ENET_PEER_PACKET_THROTTLE_SCALE;
+    t.packet_loss_max = 0.0f;
+    t.queued_reliable_bytes = 0;
+    t.queued_unreliable_bytes = 0;
+    t.bytes_in_per_sec = 0.0f;
+    t.bytes_out_per_sec = 0.0f;
+    t.send_failures = send_failures_.load(std::memory_order_relaxed);
+    t.busiest_peers.clear();
+
+    uint64_t rtt_sum = 0;
+    uint64_t rtt_variance_sum = 0;
+    double loss_sum = 0.0;
+
+    for (auto& [id, peer] : peers_) {
+        PeerTelemetry& pt = peer.telemetry;
+        getPeerLinkStats(id, pt.link);
+
+        if (elapsed > 0.0f) {
+            pt.bytes_in_per_sec = static_cast<float>(pt.traffic.bytes_in - peer.sampled_bytes_in) / elapsed;
+            pt.bytes_out_per_sec = static_cast<float>(pt.traffic.bytes_out - peer.sampled_bytes_out) / elapsed;
+        }
+        peer.sampled_bytes_in = pt.traffic.bytes_in;
+        peer.sampled_bytes_out = pt.traffic.bytes_out;
+
+        const PeerLinkStats& link = pt.link;
+        t.rtt_min = std::min(t.rtt_min, link.round_trip_time);
+        t.rtt_max = std::max(t.rtt_max, link.round_trip_time);
+        rtt_sum += link.round_trip_time;
+        rtt_variance_sum += link.round_trip_time_variance;
+        loss_sum += link.packet_loss;
+        t.packet_loss_max = std::max(t.packet_loss_max, link.packet_loss);
+        t.throttle_min = std::min(t.throttle_min, link.packet_throttle);
+        t.queued_reliable_bytes += link.queued_reliable_bytes;
+        t.queued_unreliable_bytes += link.queued_unreliable_bytes;
+        t.bytes_in_per_sec += pt.bytes_in_per_sec;
+        t.bytes_out_per_sec += pt.bytes_out_per_sec;
+
+        t.busiest_peers.push_back({id, link.queued_bytes, pt.bytes_out_per_sec, link.round_trip_time});
+    }
+
+    if (t.peers > 0) {
+        t.rtt_avg = static_cast<uint32_t>(rtt_sum / t.peers);
+        t.rtt_variance_avg = static_cast<uint32_t>(rtt_variance_sum / t.peers);
+        t.packet_loss_avg = static_cast<float>(loss_sum / t.peers);
+    } else {
+        t.rtt_avg = 0;
+        t.rtt_variance_avg = 0;
+        t.packet_loss_avg = 0.0f;
+    }
+
+    // Maior fila primeiro; empate pela taxa de saída
+    size_t top = std::min(kTelemetryBusiestPeers, t.busiest_peers.size());
+    std::partial_sort(t.busiest_peers.begin(), t.busiest_peers.begin() + top, t.busiest_peers.end(),
+                      [](const NetworkTelemetry::PeerEntry& a, const NetworkTelemetry::PeerEntry& b) {
+                          if (a.queued_bytes != b.queued_bytes) {
+                              return a.queued_bytes > b.queued_bytes;
+                          }
+                          return a.bytes_out_per_sec > b.bytes_out_per_sec;
+                      });
+    t.busiest_peers.resize(top);
+}
+
+bool NetworkManager::getPeerTelemetry(uint32_t peer_id, PeerTelemetry& out) const {
+    const SimPeer* peer = peers_.find(peer_id);
+    if (!peer) {
+        return false;
+    }
+    out = peer->telemetry;
+    return true;
+}
+
+void NetworkManager::logTelemetryReport() const {
+    const NetworkTelemetry& t = telemetry_;
+
+    std::stringstream ss;
+    ss << "\n========== Network Telemetry ==========\n";
+    ss << "Peers: " << t.peers << "\n";
+    ss << "RTT: min " << t.rtt_min << " / avg " << t.rtt_avg << " / max " << t.rtt_max
+       << " ms (avg variance " << t.rtt_variance_avg << " ms)\n";
+    ss << std::fixed << std::setprecision(2);
+    ss << "Packet Loss: avg " << t.packet_loss_avg * 100.0f << "%, max " << t.packet_loss_max * 100.0f << "%\n";
+    ss << "Min Throttle: " << t.throttle_min << "/" << ENET_PEER_PACKET_THROTTLE_SCALE << "\n";
+    ss << "Queued: " << t.queued_reliable_bytes << " reliable, " << t.queued_unreliable_bytes << " unreliable bytes\n";
+    ss << std::setprecision(1);
+    ss << "Throughput: " << t.bytes_in_per_sec / 1024.0f << " KB/s in, "
+       << t.bytes_out_per_sec / 1024.0f << " KB/s out\n";
+    if (t.send_failures > 0) {
+        ss << "Send failures: " << t.send_failures << " (packets dropped by enet_peer_send)\n";
+    }
+
+    if (!t.busiest_peers.empty()) {
+        ss << "Busiest peers (queued bytes, out KB/s, RTT):\n";
+        for (const auto& entry : t.busiest_peers) {
+            ss << "  " << entry.peer_id << ": " << entry.queued_bytes << " B, "
+               << entry.bytes_out_per_sec / 1024.0f << " KB/s, " << entry.round_trip_time << " ms\n";
+        }
+    }
+
+    ss << "By packet type (in msgs/bytes, out msgs/bytes):\n";
+    for (size_t i = 0; i < t.by_type.size(); ++i) {
+        const TrafficCounters& c = t.by_type[i];
+        if (c.packets_in == 0 && c.packets_out == 0) {
+            continue;
+        }
+        auto name = magic_enum::enum_name(static_cast<PacketType>(i));
+        ss << "  " << (name.empty() ? std::to_string(i) : std::string(name)) << ": "
+           << c.packets_in << "/" << c.bytes_in << ", " << c.packets_out << "/" << c.bytes_out << "\n";
+    }
+    ss << "=======================================\n";
+
+    Logger::info(ss.str());
+}
 
 void NetworkManager::disconnectPeer(uint32_t peer_id) {
-    auto it = id_to_peer_.find(peer_id);
-    if (it != id_to_peer_.end()) {
-        enet_peer_disconnect(it->second, 0);
+    SimPeer* peer = peers_.find(peer_id);
+    if (!peer) {
+        return;
+    }
+
+    // O que estava em lote sai antes do pedido de desconexão
+    if (peer->batches.pending) {
+        flushPeer(peer_id, *peer);
     }
+
+    OutboundCommand cmd;
+    cmd.kind = OutboundCommand::Kind::DISCONNECT;
+    cmd.peer_id = peer_id;
+    submitCommand(*shards_[peer->shard], std::move(cmd));
 }
 
 size_t NetworkManager::getConnectedPeerCount() const {
-    return id_to_peer_.size();
-}
\ No newline at end of file
+    return peers_.size();
+}
+
+std::vector<uint32_t> NetworkManager::getConnectedPeerIds() const {
+    std::vector<uint32_t> ids;
+    ids.reserve(peers_.size());
+    for (const auto& [id, peer] : peers_) {
+        ids.push_back(id);
+    }
+    return ids;
+}
@@ -2,65 +2,487 @@
 #pragma once
 
 #include <enet/enet.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
 #include <functional>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <string>
 #include <cstdint>
 #include "RPCHandler.h"
 #include "RPCRegistry.h"
-enum class PacketType : uint8_t {
-    CONNECT = 0,
-    DISCONNECT,
-    AUTH_REQUEST,
-    AUTH_RESPONSE,
-    PLAYER_MOVE,
-    PLAYER_ACTION,
-    CHAT_MESSAGE,
-    WORLD_STATE,
-    RPC_CALL,
-    BROADCAST,
-    NETWORK_COMMAND_REMOTE_CALL = 0x20     // 32 em decimal
+#include "server/PeerTable.h"
+#include "server/PacketCompressor.h"
+#include "server/PacketCapture.h"
+#include "server/PacketPool.h"
+#include "server/PacketType.h"
+#include "utils/LockFreeQueue.h"
+
+class SpatialGrid;
+
+// Classes de entrega. Cada uma usa seu próprio canal ENet, então
+// retransmissões de uma classe não seguram a entrega das outras.
+enum class ChannelClass : uint8_t {
+    RELIABLE_ORDERED = 0,    // RPCs, chat, autenticação
+    UNRELIABLE_SEQUENCED,    // estado: pacotes atrasados são descartados
+    UNSEQUENCED,             // sem ordem nem confiabilidade
+    BULK,                    // transferências grandes confiáveis, nunca em lote
+    COUNT
+};
+
+constexpr size_t kChannelClassCount = static_cast<size_t>(ChannelClass::COUNT);
+
+// Canal ENet e flags de pacote de cada classe
+inline uint8_t channelFor(ChannelClass cls) { return static_cast<uint8_t>(cls); }
+uint32_t packetFlagsFor(ChannelClass cls);
+
+// Mapeia cada PacketType para uma classe de entrega
+class ChannelPolicy {
+public:
+    ChannelPolicy();
+
+    ChannelClass classFor(PacketType type) const { return classes_[static_cast<uint8_t>(type)]; }
+    void set(PacketType type, ChannelClass cls) { classes_[static_cast<uint8_t>(type)] = cls; }
+
+private:
+    std::array<ChannelClass, 256> classes_;
+};
+
+// Bytes de um pacote recebido, emprestados diretamente do ENetPacket
+// (sem cópia). Move-only: o ENetPacket é liberado quando o buffer é
+// destruído, depois do dispatch. Inclui o byte de tipo na posição 0.
+// Mensagens de um BATCH são fatias (slice) do mesmo ENetPacket: cada uma
+// soma uma referência e a última a ser solta o destrói.
+class PacketBuffer {
+public:
+    PacketBuffer() = default;
+    explicit PacketBuffer(ENetPacket* packet)
+        : packet_(packet), length_(packet ? packet->dataLength : 0) {}
+    ~PacketBuffer() { reset(); }
+
+    PacketBuffer(PacketBuffer&& other) noexcept
+        : packet_(other.packet_), offset_(other.offset_), length_(other.length_) {
+        other.packet_ = nullptr;
+        other.offset_ = other.length_ = 0;
+    }
+    PacketBuffer& operator=(PacketBuffer&& other) noexcept {
+        if (this != &other) {
+            reset();
+            packet_ = other.packet_;
+            offset_ = other.offset_;
+            length_ = other.length_;
+            other.packet_ = nullptr;
+            other.offset_ = other.length_ = 0;
+        }
+        return *this;
+    }
+    PacketBuffer(const PacketBuffer&) = delete;
+    PacketBuffer& operator=(const PacketBuffer&) = delete;
+
+    // [offset, offset + length) deste buffer, compartilhando o ENetPacket.
+    // Só na thread que também solta este buffer (a contagem não é atômica).
+    PacketBuffer slice(size_t offset, size_t length) const {
+        PacketBuffer view;
+        if (packet_) {
+            ++packet_->referenceCount;
+            view.packet_ = packet_;
+            view.offset_ = offset_ + offset;
+            view.length_ = length;
+        }
+        return view;
+    }
+
+    const uint8_t* data() const { return packet_ ? packet_->data + offset_ : nullptr; }
+    size_t size() const { return length_; }
+    bool empty() const { return size() == 0; }
+    uint8_t operator[](size_t i) const { return data()[i]; }
+
+    const uint8_t* begin() const { return data(); }
+    const uint8_t* end() const { return data() + size(); }
+
+    std::span<const uint8_t> bytes() const { return {data(), size()}; }
+    operator std::span<const uint8_t>() const { return bytes(); }
+
+    // Conteúdo após o byte de tipo
+    std::span<const uint8_t> payload() const {
+        return size() > 1 ? std::span<const uint8_t>(data() + 1, size() - 1) : std::span<const uint8_t>();
+    }
+
+    void reset() {
+        if (packet_) {
+            // Pacotes recebidos chegam com referenceCount 0; cada fatia soma 1
+            if (packet_->referenceCount > 0) {
+                --packet_->referenceCount;
+            } else {
+                enet_packet_destroy(packet_);
+            }
+            packet_ = nullptr;
+            offset_ = length_ = 0;
+        }
+    }
+
+private:
+    ENetPacket* packet_ = nullptr;
+    size_t offset_ = 0;
+    size_t length_ = 0;
 };
 
 struct Packet {
     PacketType type;
-    std::vector<uint8_t> data;
+    PacketBuffer data;
     uint32_t peer_id;
 };
 
+// Comando de saída da thread de simulação para a thread de I/O
+struct OutboundCommand {
+    // RELEASE solta a referência extra de um pacote compartilhado por
+    // vários SEND (multicast), depois de todos eles
+    enum class Kind : uint8_t { SEND, BROADCAST, DISCONNECT, RELEASE };
+
+    Kind kind = Kind::SEND;
+    uint8_t channel = 0;
+    uint32_t peer_id = 0;          // destino, ou peer excluído no BROADCAST
+    ENetPacket* packet = nullptr;
+};
+
+// Estado do enlace de um peer, amostrado das estatísticas da ENet
+struct PeerLinkStats {
+    uint32_t round_trip_time = 0;      // ms (média suavizada da ENet)
+    uint32_t round_trip_time_variance = 0;
+    uint32_t packet_throttle = ENET_PEER_PACKET_THROTTLE_SCALE;   // 0..THROTTLE_SCALE
+    float packet_loss = 0.0f;          // 0..1
+    size_t queued_reliable_bytes = 0;
+    size_t queued_unreliable_bytes = 0;
+    size_t queued_bytes = 0;           // total ainda na fila de saída da ENet
+    uint32_t reliable_in_transit = 0;  // bytes confiáveis enviados sem ACK
+};
+
+// Mensagens e bytes (incluindo o byte de tipo) em cada sentido. Mensagens
+// em lote contam individualmente; broadcasts contam uma vez por destinatário.
+struct TrafficCounters {
+    uint64_t packets_in = 0;
+    uint64_t bytes_in = 0;
+    uint64_t packets_out = 0;
+    uint64_t bytes_out = 0;
+};
+
+struct PeerTelemetry {
+    PeerLinkStats link;                // última amostra (1 s)
+    TrafficCounters traffic;           // desde a conexão
+    float bytes_in_per_sec = 0.0f;     // no último intervalo de amostragem
+    float bytes_out_per_sec = 0.0f;
+};
+
+// Agregado de todos os peers, recalculado a cada amostragem
+struct NetworkTelemetry {
+    size_t peers = 0;
+    uint32_t rtt_min = 0;
+    uint32_t rtt_avg = 0;
+    uint32_t rtt_max = 0;
+    uint32_t rtt_variance_avg = 0;
+    float packet_loss_avg = 0.0f;
+    float packet_loss_max = 0.0f;
+    uint32_t throttle_min = ENET_PEER_PACKET_THROTTLE_SCALE;
+    size_t queued_reliable_bytes = 0;
+    size_t queued_unreliable_bytes = 0;
+    float bytes_in_per_sec = 0.0f;
+    float bytes_out_per_sec = 0.0f;
+    // enet_peer_send recusados desde o início (pacote descartado)
+    uint64_t send_failures = 0;
+
+    // Peers com mais bytes na fila de saída (candidatos a saturação)
+    struct PeerEntry {
+        uint32_t peer_id;
+        size_t queued_bytes;
+        float bytes_out_per_sec;
+        uint32_t round_trip_time;
+    };
+    std::vector<PeerEntry> busiest_peers;
+
+    // Por PacketType, desde o início
+    std::array<TrafficCounters, 256> by_type{};
+};
+
+struct NetworkOptions {
+    // Serve o host ENet em uma thread dedicada; a simulação troca pacotes
+    // com ela por filas sem lock
+    bool io_thread = false;
+    size_t queue_capacity = 16384;
+
+    // Número de hosts ENet, cada um com sua própria thread de I/O
+    // (host_count > 1 implica io_thread). Com reuse_port todos escutam na
+    // mesma porta via SO_REUSEPORT; sem ele (ou onde não há suporte)
+    // usam as portas port .. port + host_count - 1. A escolha vale para
+    // todos: se o primeiro host não conseguir SO_REUSEPORT, todos usam
+    // portas próprias; se um host seguinte falhar, initialize() falha.
+    size_t host_count = 1;
+    bool reuse_port = true;
+
+    // Agrupa as mensagens pequenas de cada peer em pacotes BATCH de até
+    // batch_size bytes, enviados uma vez por tick em flush(). Desligado por
+    // padrão: só clientes que abrem o envelope BATCH podem usar.
+    bool batching = false;
+    size_t batch_size = 1200;
+
+    ChannelPolicy channels;
+
+    // Compressão dos datagramas: uma entrada vale para todos os hosts,
+    // senão uma por host (hosts sem entrada ficam sem compressão)
+    std::vector<CompressionMode> compression;
+    int compression_level = 3;
+    std::string compression_dictionary;   // arquivo do dicionário (ZSTD_DICT)
+
+    // Buffers de saída reutilizados (excedentes são alocados à parte)
+    size_t packet_pool_size = 4096;
+
+    // Grava todo pacote recebido neste arquivo (ver PacketCapture)
+    std::string capture_file;
+    // Modo replay: não abre sockets; pollEvents entrega os pacotes da
+    // captura do tick atual (ver endTick) e os envios são descartados
+    std::string replay_file;
+};
+
 class NetworkManager {
 public:
-    NetworkManager(uint16_t port, size_t max_clients);
+    NetworkManager(uint16_t port, size_t max_clients, const NetworkOptions& options = {});
     ~NetworkManager();
 
     bool initialize();
     void shutdown();
-    
-    // Polling de eventos (call from main loop)
-    std::vector<Packet> pollEvents(uint32_t timeout_ms = 0);
-    
-    // Envio de dados
-    bool sendPacket(uint32_t peer_id, PacketType type, const std::vector<uint8_t>& data, bool reliable = true);
+
+    // Polling de eventos (call from main loop). No modo com thread de I/O
+    // apenas drena as filas de entrada e ignora o timeout.
+    // Os pacotes ficam numa arena reutilizada a cada tick e continuam
+    // válidos até releasePackets() ou o próximo pollEvents().
+    std::vector<Packet>& pollEvents(uint32_t timeout_ms = 0);
+
+    // Devolve os ENetPackets do tick à ENet (chamar após o dispatch)
+    void releasePackets();
+
+    // Chamado pelas threads de I/O sempre que entregam pacotes novos à
+    // simulação (ex.: TickScheduler::notify). Definir antes de initialize().
+    void setInboundNotifier(std::function<void()> notifier) { inbound_notifier_ = std::move(notifier); }
+    // Sockets que a thread de simulação pode esperar (vazio no modo com
+    // threads de I/O ou em replay)
+    std::vector<ENetSocket> getPollSockets() const;
+
+    // Captura dos pacotes recebidos (pode ser ligada/desligada em execução)
+    bool startCapture(const std::string& path);
+    void stopCapture();
+    bool isCapturing() const { return capture_.isOpen(); }
+
+    bool isReplaying() const { return replay_ != nullptr; }
+    // Todos os pacotes da captura já foram entregues
+    bool isReplayFinished() const { return replay_ && replay_->finished(); }
+
+    // Envio de dados. Com batching, mensagens pequenas ficam retidas até flush().
+    // Sem classe explícita, usa a da ChannelPolicy para o tipo.
+    bool sendPacket(uint32_t peer_id, PacketType type, const std::vector<uint8_t>& data);
+    bool sendPacket(uint32_t peer_id, PacketType type, const std::vector<uint8_t>& data, ChannelClass cls);
     bool broadcastPacket(PacketType type, const std::vector<uint8_t>& data, uint32_t exclude_peer = 0);
-    // void sendRPC(uint32_t peer_id, const std::string& node_path,
-    //                   const std::string& method, const std::vector<Variant>& args,
-    //                   bool reliable = true);
-                      
+
+    // Pacote montado direto num buffer do pool (ver OutboundPacket).
+    // Só na thread de simulação.
+    OutboundPacket createPacket(PacketType type) { return OutboundPacket(type, packet_pool_.acquire()); }
+    bool sendPacket(uint32_t peer_id, OutboundPacket&& packet);
+    bool sendPacket(uint32_t peer_id, OutboundPacket&& packet, ChannelClass cls);
+    bool broadcastPacket(OutboundPacket&& packet, uint32_t exclude_peer = 0);
+    // Mesmo pacote para vários peers, serializado uma vez. Retorna quantos
+    // destinatários estavam conectados (ids repetidos recebem de novo).
+    size_t multicastPacket(OutboundPacket&& packet, std::span<const uint32_t> peer_ids);
+
+    // RPCs para clientes Godot no formato comprimido (rpc_wire::writeCall).
+    // node_id e method_id são os ids de cache do Godot; a classe de entrega
+    // é a da ChannelPolicy para NETWORK_COMMAND_REMOTE_CALL.
+    bool sendRPC(uint32_t peer_id, uint32_t node_id, uint16_t method_id, std::span<const Variant> args);
+    size_t multicastRPC(std::span<const uint32_t> peer_ids, uint32_t node_id, uint16_t method_id,
+                        std::span<const Variant> args);
+    // Peers a até 'radius' de (x, z) no grid (os ids do grid são peer ids)
+    size_t sendRPCNear(SpatialGrid& grid, float x, float z, float radius, uint32_t node_id,
+                       uint16_t method_id, std::span<const Variant> args, uint32_t exclude_peer = 0);
+
+    // RPCs enfileirados: as chamadas do tick para um peer saem juntas em
+    // flush(), num frame NETWORK_COMMAND_REMOTE_CALL_BATCH (uma só vai como
+    // RPC comum). Um sendRPC direto envia antes os enfileirados do peer.
+    bool queueRPC(uint32_t peer_id, uint32_t node_id, uint16_t method_id, std::span<const Variant> args);
+    // Serializa uma vez e acrescenta ao lote de cada peer
+    size_t queueRPC(std::span<const uint32_t> peer_ids, uint32_t node_id, uint16_t method_id,
+                    std::span<const Variant> args);
+
+    // Envia os lotes pendentes de todos os peers (chamar no fim do tick)
+    void flush();
+
+    // Encerra o tick da simulação: pacotes recebidos daqui em diante (mesmo
+    // em polls antecipados por tráfego) são gravados/reproduzidos no próximo
+    void endTick() { ++sim_tick_; }
+
     // Gerenciamento de peers
     void disconnectPeer(uint32_t peer_id);
     size_t getConnectedPeerCount() const;
-    
+
+    // Estatísticas de enlace do peer. No modo com threads são amostradas
+    // pela thread de I/O a cada 100 ms.
+    bool getPeerLinkStats(uint32_t peer_id, PeerLinkStats& out);
+    std::vector<uint32_t> getConnectedPeerIds() const;
+
+    // Telemetria amostrada a cada segundo (em flush()). Só na thread de simulação.
+    bool getPeerTelemetry(uint32_t peer_id, PeerTelemetry& out) const;
+    const NetworkTelemetry& getTelemetry() const { return telemetry_; }
+    void logTelemetryReport() const;
+
     RPCHandler& getRPCHandler() { return rpc_handler_; }
-    ENetHost* getHost() const { return host_; }
+    // Número total de slots de peer (todos os shards); os handles de peer
+    // têm slot menor que isto
+    size_t getPeerSlotCount() const { return shards_.size() * peers_per_host_; }
+
+    // Host do primeiro shard. Não usar da thread de simulação quando isThreaded()
+    ENetHost* getHost() const { return shards_.empty() ? nullptr : shards_[0]->host; }
+    size_t getHostCount() const { return shards_.size(); }
+    bool isThreaded() const { return options_.io_thread; }
+    const ChannelPolicy& getChannelPolicy() const { return options_.channels; }
 
 private:
-    ENetHost* host_;
+    // Um host ENet e o estado que só a thread que o serve toca
+    struct HostShard {
+        size_t index = 0;
+        uint16_t port = 0;
+        ENetHost* host = nullptr;
+
+        // O slot global de host->peers[i] é slot_offset + i. O handle do
+        // peer conectado fica em ENetPeer::data.
+        size_t slot_offset = 0;
+        std::vector<uint16_t> generations;
+
+        std::thread thread;
+        std::unique_ptr<SpscQueue<Packet>> inbound_queue;
+        std::unique_ptr<MpscQueue<OutboundCommand>> outbound_queue;
+        std::deque<Packet> inbound_backlog;
+
+        // Última amostra publicada pela thread de I/O
+        // (indexada pelo slot local; id 0 = sem peer)
+        struct LinkSample {
+            uint32_t id = 0;
+            PeerLinkStats stats;
+        };
+        std::mutex link_stats_mutex;
+        std::vector<LinkSample> link_stats;
+        uint32_t last_link_sample = 0;
+    };
+
+    bool createShardHost(HostShard& shard, size_t peer_limit);
+    CompressionMode compressionFor(size_t host_index) const;
+    bool loadCompressionDictionary();
+
+    // Converte um evento ENet em Packet, mantendo os mapas do shard.
+    // Só a thread que serve o host chama.
+    bool translateEvent(HostShard& shard, const ENetEvent& event, Packet& out);
+    void executeCommand(HostShard& shard, const OutboundCommand& cmd);
+    void submitCommand(HostShard& shard, OutboundCommand&& cmd);
+    HostShard* findShard(uint32_t peer_id);
+    // Peer do shard com este handle, ou nullptr se o slot mudou de dono.
+    // Só a thread que serve o host chama.
+    ENetPeer* resolvePeer(HostShard& shard, uint32_t peer_id) const;
+    void trackPeer(const Packet& pkt, uint16_t shard_index);
+    // Entrega um pacote recebido à simulação, abrindo o envelope BATCH
+    void acceptInbound(Packet&& pkt, uint16_t shard_index);
+    void capturePackets();
+    void pollReplay();
+
+    // Mensagens acumuladas para um peer numa classe de entrega
+    struct OutboundBatch {
+        PooledBufferPtr buffer;        // [BATCH]([len][mensagem])...
+        size_t count = 0;
+        size_t first_offset = 0;       // início da primeira mensagem
+    };
+
+    struct PeerBatches {
+        std::array<OutboundBatch, kChannelClassCount> by_class;
+        OutboundBatch rpc;             // [0x21]([len][0x20][chamada])...
+        bool pending = false;
+    };
+
+    // Estado de um peer conectado visto pela thread de simulação
+    struct SimPeer {
+        uint16_t shard = 0;
+        PeerBatches batches;
+        PeerTelemetry telemetry;
+        uint64_t sampled_bytes_in = 0;     // contadores na amostragem anterior
+        uint64_t sampled_bytes_out = 0;
+    };
+
+    void countOutbound(SimPeer& peer, PacketType type, size_t bytes);
+    void sampleTelemetry();
+
+    void flushPeer(uint32_t peer_id, SimPeer& peer);
+
+    // Acrescenta a mensagem ao lote do peer. false se ela não pode ir em
+    // lote (o lote atual já foi enviado, para manter a ordem).
+    bool appendToBatch(uint32_t peer_id, SimPeer& peer, PacketType type,
+                       std::span<const uint8_t> payload, ChannelClass cls);
+    void sendBuffer(uint32_t peer_id, SimPeer& peer, PooledBufferPtr buffer, ChannelClass cls);
+    void broadcastBuffer(PooledBufferPtr buffer, PacketType type, uint32_t exclude_peer);
+    size_t multicastBuffer(PooledBufferPtr buffer, std::span<const uint32_t> peer_ids, ChannelClass cls);
+    OutboundPacket createRPCPacket(uint32_t node_id, uint16_t method_id, std::span<const Variant> args);
+    bool encodeRPCCall(uint32_t node_id, uint16_t method_id, std::span<const Variant> args);
+    void appendToRPCBatch(uint32_t peer_id, SimPeer& peer, std::span<const uint8_t> call);
+
+    void enqueueSend(HostShard& shard, uint32_t peer_id, ChannelClass cls, ENetPacket* packet);
+    void emitBatch(HostShard& shard, uint32_t peer_id, OutboundBatch& batch, ChannelClass cls);
+
+    void sampleLinkStats(HostShard& shard);
+
+    void ioThreadMain(HostShard& shard);
+    void drainOutbound(HostShard& shard);
+    void pushInbound(HostShard& shard, Packet&& pkt);
+
     RPCHandler rpc_handler_;
     uint16_t port_;
     size_t max_clients_;
-    
-    // Mapeia ENetPeer* para IDs únicos
-    std::unordered_map<ENetPeer*, uint32_t> peer_to_id_;
-    std::unordered_map<uint32_t, ENetPeer*> id_to_peer_;
-    uint32_t next_peer_id_;
-};
\ No newline at end of file
+    NetworkOptions options_;
+
+    // Antes de shards_ e peers_: buffers em uso voltam ao pool quando
+    // os hosts e os lotes são destruídos
+    PacketPool packet_pool_;
+
+    std::vector<std::unique_ptr<HostShard>> shards_;
+    size_t peers_per_host_ = 0;
+    CompressionDictionary compression_dictionary_;
+
+    // Peers conectados vistos pela thread de simulação
+    PeerTable<SimPeer> peers_;
+
+    // Arena de pacotes do tick (capacidade preservada entre ticks)
+    std::vector<Packet> inbound_packets_;
+
+    // Peers com lote pendente neste tick
+    std::vector<uint32_t> pending_batches_;
+
+    // Pacote de cada shard no multicast em andamento
+    std::vector<ENetPacket*> multicast_packets_;
+    // Chamada [0x20][chamada] sendo enfileirada (capacidade preservada)
+    std::vector<uint8_t> rpc_call_scratch_;
+    // Destinatários de sendRPCNear
+    std::vector<uint32_t> near_peers_;
+
+    // Tick da simulação que vai processar os pacotes recebidos agora (tick
+    // das capturas). Começa em 1, como o replay.
+    uint64_t sim_tick_ = 1;
+    PacketCaptureWriter capture_;
+    std::unique_ptr<PacketCaptureReader> replay_;
+
+    std::function<void()> inbound_notifier_;
+
+    NetworkTelemetry telemetry_;
+    std::chrono::steady_clock::time_point last_telemetry_sample_;
+    std::atomic<uint64_t> send_failures_{0};     // incrementado pelas threads de I/O
+    size_t unreported_sent_ = 0;                 // mensagens ainda não passadas ao PerformanceMonitor
+
+    std::atomic<bool> io_running_;
+};
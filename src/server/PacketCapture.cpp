@@ -0,0 +1,136 @@
+// src/server/PacketCapture.cpp
+#include "server/PacketCapture.h"
+#include "utils/BinaryStream.h"
+#include "utils/Logger.h"
+#include <cstring>
+#include <iterator>
+
+static constexpr char kCaptureMagic[4] = {'E', 'N', 'C', 'P'};
+static constexpr uint8_t kCaptureVersion = 1;
+static constexpr size_t kCaptureFlushSize = 64 * 1024;
+
+// =============================================================
+// Gravação
+// =============================================================
+bool PacketCaptureWriter::open(const std::string& path, uint64_t start_tick) {
+    close();
+
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_) {
+        Logger::error("Failed to open packet capture file: " + path);
+        return false;
+    }
+
+    buffer_.clear();
+    BinaryWriter writer(buffer_);
+    writer.writeBytes(kCaptureMagic, sizeof(kCaptureMagic));
+    writer.writeU8(kCaptureVersion);
+
+    last_tick_ = start_tick;
+    record_count_ = 0;
+    Logger::info("Capturing inbound packets to " + path);
+    return true;
+}
+
+void PacketCaptureWriter::close() {
+    if (!file_.is_open()) {
+        return;
+    }
+
+    flushBuffer();
+    file_.close();
+    Logger::info("Packet capture closed (" + std::to_string(record_count_) + " packets)");
+}
+
+void PacketCaptureWriter::record(uint64_t tick, uint32_t peer_id, PacketType type,
+                                 const uint8_t* data, size_t size) {
+    if (!file_.is_open()) {
+        return;
+    }
+
+    BinaryWriter writer(buffer_);
+    writer.writeVarUInt(static_cast<uint32_t>(tick - last_tick_));
+    writer.writeU32(peer_id);
+    writer.writeU8(static_cast<uint8_t>(type));
+    writer.writeVarUInt(static_cast<uint32_t>(size));
+    writer.writeBytes(data, size);
+
+    last_tick_ = tick;
+    ++record_count_;
+
+    if (buffer_.size() >= kCaptureFlushSize) {
+        flushBuffer();
+    }
+}
+
+void PacketCaptureWriter::flushBuffer() {
+    file_.write(reinterpret_cast<const char*>(buffer_.data()), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+}
+
+// =============================================================
+// Leitura
+// =============================================================
+bool PacketCaptureReader::open(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        Logger::error("Failed to open packet capture file: " + path);
+        return false;
+    }
+
+    data_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    offset_ = 0;
+    tick_ = 0;
+
+    if (data_.size() < sizeof(kCaptureMagic) + 1 ||
+        std::memcmp(data_.data(), kCaptureMagic, sizeof(kCaptureMagic)) != 0) {
+        Logger::error("Not a packet capture file: " + path);
+        return false;
+    }
+    if (data_[sizeof(kCaptureMagic)] != kCaptureVersion) {
+        Logger::error("Unsupported packet capture version: " + std::to_string(data_[sizeof(kCaptureMagic)]));
+        return false;
+    }
+
+    offset_ = sizeof(kCaptureMagic) + 1;
+    Logger::info("Loaded packet capture " + path + " (" + std::to_string(data_.size()) + " bytes)");
+    return true;
+}
+
+bool PacketCaptureReader::next(CaptureRecord& out) {
+    if (finished()) {
+        return false;
+    }
+
+    try {
+        BinaryReader reader(data_.data() + offset_, data_.size() - offset_);
+        out.tick = tick_ + reader.readVarUInt();
+        out.peer_id = reader.readU32();
+        out.type = static_cast<PacketType>(reader.readU8());
+        out.size = reader.readVarUInt();
+        out.data = reader.readBytes(out.size);
+
+        tick_ = out.tick;
+        offset_ = static_cast<size_t>(reader.position() - data_.data());
+        return true;
+    } catch (const std::exception& e) {
+        Logger::warning("Truncated packet capture: " + std::string(e.what()));
+        offset_ = data_.size();
+        return false;
+    }
+}
+
+bool PacketCaptureReader::peekTick(uint64_t& tick) {
+    if (finished()) {
+        return false;
+    }
+
+    try {
+        BinaryReader reader(data_.data() + offset_, data_.size() - offset_);
+        tick = tick_ + reader.readVarUInt();
+        return true;
+    } catch (const std::exception&) {
+        offset_ = data_.size();
+        return false;
+    }
+}
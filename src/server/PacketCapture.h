@@ -0,0 +1,64 @@
+// include/server/PacketCapture.h
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "server/PacketType.h"
+
+// Formato de captura de pacotes recebidos (little-endian):
+//
+//   cabeçalho: "ENCP" [u8 versão]
+//   registro:  [varuint ticks desde o registro anterior][u32 peer][u8 tipo]
+//              [varuint tamanho][bytes do pacote, incluindo o byte de tipo]
+//
+// CONNECT e DISCONNECT têm tamanho 0. O tipo é o já classificado pelo
+// NetworkManager (ex.: 0x20 -> NETWORK_COMMAND_REMOTE_CALL).
+struct CaptureRecord {
+    uint64_t tick = 0;
+    uint32_t peer_id = 0;
+    PacketType type = PacketType::CONNECT;
+    const uint8_t* data = nullptr;   // válido enquanto o reader existir
+    size_t size = 0;
+};
+
+class PacketCaptureWriter {
+public:
+    ~PacketCaptureWriter() { close(); }
+
+    // start_tick: tick atual de quem grava; o primeiro registro guarda a
+    // distância até ele, então o replay começa no tick 1
+    bool open(const std::string& path, uint64_t start_tick = 0);
+    void close();
+    bool isOpen() const { return file_.is_open(); }
+
+    void record(uint64_t tick, uint32_t peer_id, PacketType type, const uint8_t* data, size_t size);
+
+    uint64_t getRecordCount() const { return record_count_; }
+
+private:
+    void flushBuffer();
+
+    std::ofstream file_;
+    std::vector<uint8_t> buffer_;   // escrito no arquivo a cada ~64 KB
+    uint64_t last_tick_ = 0;
+    uint64_t record_count_ = 0;
+};
+
+// Lê a captura inteira para a memória, para que o replay não espere disco
+class PacketCaptureReader {
+public:
+    bool open(const std::string& path);
+
+    // Próximo registro; false no fim ou se o arquivo estiver truncado
+    bool next(CaptureRecord& out);
+    // Tick do próximo registro sem consumi-lo
+    bool peekTick(uint64_t& tick);
+    bool finished() const { return offset_ >= data_.size(); }
+
+private:
+    std::vector<uint8_t> data_;
+    size_t offset_ = 0;
+    uint64_t tick_ = 0;
+};
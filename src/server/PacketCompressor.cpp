@@ -0,0 +1,178 @@
+// src/server/PacketCompressor.cpp
+#include "server/PacketCompressor.h"
+#include "utils/Logger.h"
+#include "utils/PerformanceMonitor.h"
+#include <zstd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+uint64_t elapsedNs(std::chrono::steady_clock::time_point start) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+// =============================================================
+// Range coder da ENet (envolvido para alimentar os contadores)
+// =============================================================
+size_t rangeCompress(void* context, const ENetBuffer* buffers, size_t buffer_count, size_t in_limit,
+                     enet_uint8* out, size_t out_limit) {
+    auto start = std::chrono::steady_clock::now();
+    size_t result = enet_range_coder_compress(context, buffers, buffer_count, in_limit, out, out_limit);
+    PerformanceMonitor::getInstance().recordCompression(in_limit, result ? result : in_limit, elapsedNs(start));
+    return result;
+}
+
+size_t rangeDecompress(void* context, const enet_uint8* in, size_t in_limit,
+                       enet_uint8* out, size_t out_limit) {
+    auto start = std::chrono::steady_clock::now();
+    size_t result = enet_range_coder_decompress(context, in, in_limit, out, out_limit);
+    if (result) {
+        PerformanceMonitor::getInstance().recordDecompression(in_limit, result, elapsedNs(start));
+    }
+    return result;
+}
+
+// =============================================================
+// zstd
+// =============================================================
+
+class ZstdCompressor {
+public:
+    ZstdCompressor(int level, CompressionDictionary dictionary)
+        : level_(level), dictionary_(std::move(dictionary)),
+          cctx_(ZSTD_createCCtx()), dctx_(ZSTD_createDCtx()) {
+        if (dictionary_) {
+            cdict_ = ZSTD_createCDict(dictionary_->data(), dictionary_->size(), level_);
+            ddict_ = ZSTD_createDDict(dictionary_->data(), dictionary_->size());
+        }
+    }
+
+    ~ZstdCompressor() {
+        ZSTD_freeCDict(cdict_);
+        ZSTD_freeDDict(ddict_);
+        ZSTD_freeCCtx(cctx_);
+        ZSTD_freeDCtx(dctx_);
+    }
+
+    bool valid() const {
+        return cctx_ && dctx_ && (!dictionary_ || (cdict_ && ddict_));
+    }
+
+    size_t compress(const ENetBuffer* buffers, size_t buffer_count, size_t in_limit,
+                    enet_uint8* out, size_t out_limit) {
+        auto start = std::chrono::steady_clock::now();
+
+        // A ENet entrega o datagrama em pedaços; o zstd quer contíguo
+        scratch_.resize(in_limit);
+        size_t offset = 0;
+        for (size_t i = 0; i < buffer_count && offset < in_limit; ++i) {
+            size_t length = std::min(buffers[i].dataLength, in_limit - offset);
+            std::memcpy(scratch_.data() + offset, buffers[i].data, length);
+            offset += length;
+        }
+
+        size_t result = cdict_
+            ? ZSTD_compress_usingCDict(cctx_, out, out_limit, scratch_.data(), offset, cdict_)
+            : ZSTD_compressCCtx(cctx_, out, out_limit, scratch_.data(), offset, level_);
+
+        // Erro ou sem ganho: a ENet envia o datagrama sem compressão
+        if (ZSTD_isError(result) || result >= offset) {
+            result = 0;
+        }
+
+        PerformanceMonitor::getInstance().recordCompression(offset, result ? result : offset, elapsedNs(start));
+        return result;
+    }
+
+    size_t decompress(const enet_uint8* in, size_t in_limit, enet_uint8* out, size_t out_limit) {
+        auto start = std::chrono::steady_clock::now();
+
+        size_t result = ddict_
+            ? ZSTD_decompress_usingDDict(dctx_, out, out_limit, in, in_limit, ddict_)
+            : ZSTD_decompressDCtx(dctx_, out, out_limit, in, in_limit);
+        if (ZSTD_isError(result)) {
+            return 0;
+        }
+
+        PerformanceMonitor::getInstance().recordDecompression(in_limit, result, elapsedNs(start));
+        return result;
+    }
+
+private:
+    int level_;
+    CompressionDictionary dictionary_;
+    ZSTD_CCtx* cctx_;
+    ZSTD_DCtx* dctx_;
+    ZSTD_CDict* cdict_ = nullptr;
+    ZSTD_DDict* ddict_ = nullptr;
+    std::vector<uint8_t> scratch_;
+};
+
+size_t zstdCompress(void* context, const ENetBuffer* buffers, size_t buffer_count, size_t in_limit,
+                    enet_uint8* out, size_t out_limit) {
+    return static_cast<ZstdCompressor*>(context)->compress(buffers, buffer_count, in_limit, out, out_limit);
+}
+
+size_t zstdDecompress(void* context, const enet_uint8* in, size_t in_limit,
+                      enet_uint8* out, size_t out_limit) {
+    return static_cast<ZstdCompressor*>(context)->decompress(in, in_limit, out, out_limit);
+}
+
+void zstdDestroy(void* context) {
+    delete static_cast<ZstdCompressor*>(context);
+}
+
+}
+
+// =============================================================
+// Instalação
+// =============================================================
+bool installCompressor(ENetHost* host, CompressionMode mode, int level,
+                       const CompressionDictionary& dictionary) {
+    switch (mode) {
+        case CompressionMode::NONE:
+            enet_host_compress(host, nullptr);
+            return true;
+
+        case CompressionMode::RANGE_CODER: {
+            ENetCompressor enet_compressor;
+            enet_compressor.context = enet_range_coder_create();
+            if (!enet_compressor.context) {
+                return false;
+            }
+            enet_compressor.compress = rangeCompress;
+            enet_compressor.decompress = rangeDecompress;
+            enet_compressor.destroy = enet_range_coder_destroy;
+            enet_host_compress(host, &enet_compressor);
+            return true;
+        }
+
+        case CompressionMode::ZSTD:
+        case CompressionMode::ZSTD_DICT: {
+            if (mode == CompressionMode::ZSTD_DICT && (!dictionary || dictionary->empty())) {
+                Logger::error("ZSTD_DICT compression requires a dictionary");
+                return false;
+            }
+
+            auto compressor = std::make_unique<ZstdCompressor>(
+                level, mode == CompressionMode::ZSTD_DICT ? dictionary : nullptr);
+            if (!compressor->valid()) {
+                Logger::error("Failed to create zstd compressor");
+                return false;
+            }
+
+            ENetCompressor enet_compressor;
+            enet_compressor.context = compressor.release();
+            enet_compressor.compress = zstdCompress;
+            enet_compressor.decompress = zstdDecompress;
+            enet_compressor.destroy = zstdDestroy;
+            // A ENet copia a struct e chama destroy ao trocar ou destruir o host
+            enet_host_compress(host, &enet_compressor);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,28 @@
+// include/server/PacketCompressor.h
+#pragma once
+
+#include <enet/enet.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Compressão dos datagramas ENet de um host. A ENet chama o compressor
+// na thread que serve o host, então cada host tem o seu.
+//
+//   RANGE_CODER  compressor embutido da ENet
+//   ZSTD         zstd sem dicionário (compatível com o modo ZSTD do Godot)
+//   ZSTD_DICT    zstd com dicionário treinado; o cliente precisa do mesmo
+enum class CompressionMode : uint8_t {
+    NONE = 0,
+    RANGE_CODER,
+    ZSTD,
+    ZSTD_DICT
+};
+
+// Dicionário zstd compartilhado (somente leitura) entre os hosts
+using CompressionDictionary = std::shared_ptr<const std::vector<uint8_t>>;
+
+// Instala o compressor no host. ZSTD_DICT exige um dicionário.
+// Retorna false (e deixa o host sem compressão) em caso de erro.
+bool installCompressor(ENetHost* host, CompressionMode mode, int level,
+                       const CompressionDictionary& dictionary);
@@ -0,0 +1,68 @@
+// src/server/PacketPool.cpp
+#include "server/PacketPool.h"
+
+// Buffers que cresceram além disso (ex.: snapshots enormes) não voltam
+// ao pool com a capacidade, para o pool não prender memória
+static constexpr size_t kMaxRetainedCapacity = 64 * 1024;
+
+void PooledBufferRelease::operator()(PooledBuffer* buffer) const {
+    PacketPool::unref(buffer);
+}
+
+PacketPool::PacketPool(size_t capacity) : capacity_(capacity), free_(capacity) {
+    buffers_.reserve(capacity);
+}
+
+PooledBufferPtr PacketPool::acquire() {
+    PooledBuffer* buffer = nullptr;
+    if (!free_.tryPop(buffer)) {
+        if (buffers_.size() < capacity_) {
+            buffers_.push_back(std::make_unique<PooledBuffer>());
+            buffer = buffers_.back().get();
+            buffer->pool = this;
+        } else {
+            buffer = new PooledBuffer();
+        }
+    }
+
+    buffer->bytes.clear();
+    buffer->references.store(1, std::memory_order_relaxed);
+    return PooledBufferPtr(buffer);
+}
+
+ENetPacket* PacketPool::wrap(const PooledBufferPtr& buffer, size_t offset, uint32_t flags) {
+    ENetPacket* packet = enet_packet_create(buffer->bytes.data() + offset, buffer->bytes.size() - offset,
+                                            flags | ENET_PACKET_FLAG_NO_ALLOCATE);
+    if (!packet) {
+        return nullptr;
+    }
+
+    buffer->references.fetch_add(1, std::memory_order_relaxed);
+    packet->userData = buffer.get();
+    packet->freeCallback = &PacketPool::onPacketFree;
+    return packet;
+}
+
+void PacketPool::onPacketFree(ENetPacket* packet) {
+    unref(static_cast<PooledBuffer*>(packet->userData));
+}
+
+void PacketPool::unref(PooledBuffer* buffer) {
+    if (buffer->references.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    if (buffer->pool) {
+        buffer->pool->release(buffer);
+    } else {
+        delete buffer;
+    }
+}
+
+void PacketPool::release(PooledBuffer* buffer) {
+    if (buffer->bytes.capacity() > kMaxRetainedCapacity) {
+        std::vector<uint8_t>().swap(buffer->bytes);
+    }
+    // A fila comporta todos os buffers do pool, então nunca enche
+    free_.tryPush(std::move(buffer));
+}
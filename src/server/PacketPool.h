@@ -0,0 +1,94 @@
+// include/server/PacketPool.h
+#pragma once
+
+#include <enet/enet.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+#include "server/PacketType.h"
+#include "utils/BinaryStream.h"
+#include "utils/LockFreeQueue.h"
+
+class PacketPool;
+
+// Buffer de saída reutilizável. Vira ENetPacket sem cópia
+// (ENET_PACKET_FLAG_NO_ALLOCATE) e volta ao pool quando a última
+// referência cai: a de quem o montou ou a de um pacote que a ENet liberou.
+struct PooledBuffer {
+    std::vector<uint8_t> bytes;
+    PacketPool* pool = nullptr;              // nullptr = excedente, deletado ao liberar
+    std::atomic<uint32_t> references{0};
+};
+
+// Solta a referência de quem montou o buffer
+struct PooledBufferRelease {
+    void operator()(PooledBuffer* buffer) const;
+};
+
+using PooledBufferPtr = std::unique_ptr<PooledBuffer, PooledBufferRelease>;
+
+// Pool de buffers de saída. acquire() só na thread de simulação; as
+// devoluções vêm de qualquer thread (a ENet libera os pacotes na thread
+// de I/O) por uma fila sem lock. Esgotado o pool, os buffers excedentes
+// são alocados e liberados normalmente.
+class PacketPool {
+public:
+    explicit PacketPool(size_t capacity);
+
+    PacketPool(const PacketPool&) = delete;
+    PacketPool& operator=(const PacketPool&) = delete;
+
+    PooledBufferPtr acquire();
+
+    // ENetPacket que aponta para bytes[offset..] sem copiar. Cada pacote
+    // segura uma referência, então o mesmo buffer pode ir para vários
+    // hosts. O buffer não pode mais ser alterado.
+    static ENetPacket* wrap(const PooledBufferPtr& buffer, size_t offset, uint32_t flags);
+
+    size_t getAllocatedCount() const { return buffers_.size(); }
+
+private:
+    friend struct PooledBufferRelease;
+
+    static void unref(PooledBuffer* buffer);
+    static void onPacketFree(ENetPacket* packet);
+    void release(PooledBuffer* buffer);
+
+    size_t capacity_;
+    std::vector<std::unique_ptr<PooledBuffer>> buffers_;
+    MpscQueue<PooledBuffer*> free_;
+};
+
+// Pacote de saída em construção: [tipo][payload], com o byte de tipo já
+// reservado. Os serializadores escrevem direto no buffer do pool e o
+// NetworkManager o entrega à ENet sem cópias intermediárias.
+class OutboundPacket {
+public:
+    OutboundPacket() = default;
+    OutboundPacket(PacketType type, PooledBufferPtr buffer) : type_(type), buffer_(std::move(buffer)) {
+        buffer_->bytes.push_back(static_cast<uint8_t>(type));
+    }
+
+    PacketType type() const { return type_; }
+    bool valid() const { return buffer_ != nullptr; }
+
+    // Acrescenta ao fim do payload
+    BinaryWriter writer() { return BinaryWriter(buffer_->bytes); }
+    std::vector<uint8_t>& bytes() { return buffer_->bytes; }
+
+    size_t size() const { return buffer_ ? buffer_->bytes.size() : 0; }
+    std::span<const uint8_t> payload() const {
+        return std::span<const uint8_t>(buffer_->bytes).subspan(1);
+    }
+
+    // Descarta o payload mantendo o tipo
+    void clearPayload() { buffer_->bytes.resize(1); }
+
+    PooledBufferPtr release() { return std::move(buffer_); }
+
+private:
+    PacketType type_ = PacketType::CONNECT;
+    PooledBufferPtr buffer_;
+};
@@ -0,0 +1,26 @@
+// include/server/PacketType.h
+#pragma once
+
+#include <cstdint>
+
+// Primeiro byte de todo pacote. Compartilhado com as ferramentas (loadbot).
+enum class PacketType : uint8_t {
+    CONNECT = 0,
+    DISCONNECT,
+    AUTH_REQUEST,
+    AUTH_RESPONSE,
+    PLAYER_MOVE,
+    PLAYER_ACTION,
+    CHAT_MESSAGE,
+    WORLD_STATE,
+    RPC_CALL,
+    BROADCAST,
+    SNAPSHOT_ACK,
+    // Várias mensagens num só pacote: [BATCH]([varuint len][tipo][payload])...
+    BATCH,
+    // Pedido/resposta de métricas do servidor (loadbot); ver Server
+    SERVER_STATS,
+    NETWORK_COMMAND_REMOTE_CALL = 0x20,    // 32 em decimal
+    // Várias chamadas RPC Godot: [0x21]([varuint len][0x20][chamada])...
+    NETWORK_COMMAND_REMOTE_CALL_BATCH = 0x21
+};
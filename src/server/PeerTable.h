@@ -0,0 +1,121 @@
+// include/server/PeerTable.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Handle de peer: [geração:12][slot:20]. O slot é a posição do ENetPeer
+// no array de peers do host (somada ao offset do shard) e a geração muda
+// a cada conexão no slot, então handles antigos nunca casam com o novo
+// ocupante. A geração nunca é 0, logo 0 nunca é um handle válido.
+namespace peer_handle {
+constexpr uint32_t kSlotBits = 20;
+constexpr uint32_t kSlotMask = (1u << kSlotBits) - 1;
+constexpr uint32_t kGenerationMask = (1u << (32 - kSlotBits)) - 1;
+
+inline uint32_t make(uint32_t slot, uint32_t generation) {
+    return (generation << kSlotBits) | (slot & kSlotMask);
+}
+
+inline uint32_t slot(uint32_t handle) { return handle & kSlotMask; }
+inline uint32_t generation(uint32_t handle) { return handle >> kSlotBits; }
+
+// Próxima geração de um slot, pulando o 0
+inline uint32_t nextGeneration(uint32_t generation) {
+    generation = (generation + 1) & kGenerationMask;
+    return generation == 0 ? 1 : generation;
+}
+}
+
+// Mapa handle -> T indexado pelo slot (sparse set): busca é indexação
+// de array com checagem de geração e a iteração percorre um vetor denso.
+// A remoção troca o último elemento para a posição removida, então não
+// remover durante a iteração.
+template<typename T>
+class PeerTable {
+public:
+    struct Entry {
+        uint32_t id;
+        T value;
+    };
+
+    explicit PeerTable(size_t slot_count = 0) : sparse_(slot_count, kEmpty) {}
+
+    T* find(uint32_t id) {
+        size_t index = denseIndex(id);
+        return index != kEmpty ? &dense_[index].value : nullptr;
+    }
+
+    const T* find(uint32_t id) const {
+        size_t index = denseIndex(id);
+        return index != kEmpty ? &dense_[index].value : nullptr;
+    }
+
+    bool contains(uint32_t id) const { return denseIndex(id) != kEmpty; }
+
+    // Insere ou substitui; um ocupante antigo do mesmo slot é descartado
+    T& insert(uint32_t id, T value) {
+        uint32_t slot = peer_handle::slot(id);
+        if (slot >= sparse_.size()) {
+            sparse_.resize(slot + 1, kEmpty);
+        }
+
+        uint32_t& index = sparse_[slot];
+        if (index != kEmpty) {
+            dense_[index].id = id;
+            dense_[index].value = std::move(value);
+            return dense_[index].value;
+        }
+
+        index = static_cast<uint32_t>(dense_.size());
+        dense_.push_back(Entry{id, std::move(value)});
+        return dense_.back().value;
+    }
+
+    bool erase(uint32_t id) {
+        size_t index = denseIndex(id);
+        if (index == kEmpty) {
+            return false;
+        }
+
+        if (index != dense_.size() - 1) {
+            dense_[index] = std::move(dense_.back());
+            sparse_[peer_handle::slot(dense_[index].id)] = static_cast<uint32_t>(index);
+        }
+        dense_.pop_back();
+        sparse_[peer_handle::slot(id)] = kEmpty;
+        return true;
+    }
+
+    void clear() {
+        for (const Entry& entry : dense_) {
+            sparse_[peer_handle::slot(entry.id)] = kEmpty;
+        }
+        dense_.clear();
+    }
+
+    size_t size() const { return dense_.size(); }
+    bool empty() const { return dense_.empty(); }
+
+    auto begin() { return dense_.begin(); }
+    auto end() { return dense_.end(); }
+    auto begin() const { return dense_.begin(); }
+    auto end() const { return dense_.end(); }
+
+private:
+    static constexpr uint32_t kEmpty = ~0u;
+
+    size_t denseIndex(uint32_t id) const {
+        uint32_t slot = peer_handle::slot(id);
+        if (slot >= sparse_.size()) {
+            return kEmpty;
+        }
+        uint32_t index = sparse_[slot];
+        return (index != kEmpty && dense_[index].id == id) ? index : kEmpty;
+    }
+
+    std::vector<uint32_t> sparse_;   // slot -> posição em dense_
+    std::vector<Entry> dense_;
+};
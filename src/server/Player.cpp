@@ -1,4 +1,5 @@
 #include "Player.h"
+#include "server/World.h"
 #include "utils/Logger.h"
 #include <nlohmann/json.hpp>
 
@@ -12,6 +13,13 @@ Player::Player(uint32_t peer_id, uint64_t db_id, const std::string& username)
     position_ = Vector3{0.0f, 0.0f, 0.0f};
 }
 
+void Player::setPosition(const Vector3& pos) {
+    position_ = pos;
+    if (World* world = world_.load(std::memory_order_acquire)) {
+        world->markMoved(*this);
+    }
+}
+
 nlohmann::json Player::toJson() const {
     nlohmann::json json_data;
     json_data["peer_id"] = peer_id_;
@@ -34,9 +42,10 @@ void Player::fromJson(const nlohmann::json& json) {
         username_ = json["username"].get<std::string>();
     }
     if (json.contains("position")) {
-        position_.x = json["position"]["x"].get<float>();
-        position_.y = json["position"]["y"].get<float>();
-        position_.z = json["position"]["z"].get<float>();
+        // Por setPosition, para o índice espacial do World ver a mudança
+        setPosition(Vector3{json["position"]["x"].get<float>(),
+                            json["position"]["y"].get<float>(),
+                            json["position"]["z"].get<float>()});
     }
     if (json.contains("health")) {
         health_ = json["health"].get<int>();
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <cstdint>
 #include <nlohmann/json.hpp>
 #include "utils/Structs.h"
 
+class World;
 
 class Player {
 public:
@@ -16,11 +18,14 @@ public:
     const std::string& getUsername() const { return username_; }
     
     const Vector3& getPosition() const { return position_; }
-    void setPosition(const Vector3& pos) { position_ = pos; }
+    // Marca o jogador como movido no World em que está (ver World::update)
+    void setPosition(const Vector3& pos);
     
     int getHealth() const { return health_; }
     void setHealth(int health) { health_ = health; }
     
+    int getLevel() const { return level_; }
+    
     // Serialização
     nlohmann::json toJson() const;
     void fromJson(const nlohmann::json& json);
@@ -32,4 +37,11 @@ private:
     Vector3 position_;
     int health_;
     int level_;
+
+    // Mantidos pelo World. world_ é escrito sob World::moved_mutex_ e lido
+    // sem lock por setPosition (que pode rodar fora da thread do tick);
+    // markMoved confere de novo sob o lock. moved_ só sob o lock.
+    friend class World;
+    std::atomic<World*> world_{nullptr};
+    bool moved_ = false;
 };
\ No newline at end of file
@@ -1,5 +1,6 @@
 // RPCHandler.cpp
 #include "server/RPCHandler.h"
+#include "server/RPCWire.h"
 #include "utils/Logger.h"
 #include <cstring>
 #include <stdexcept>
@@ -29,25 +30,6 @@ uint16_t RPCHandler::decode_uint16(const uint8_t *p_arr) {
 // =============================================================
 // Read helpers
 // =============================================================
-std::string RPCHandler::readString(const uint8_t *&ptr, const uint8_t *end) {
-    if (end - ptr < 4)
-        throw std::runtime_error("EOF while reading string length");
-    uint32_t len = readU32(ptr, end);
-    if (len > static_cast<uint32_t>(end - ptr))
-        throw std::runtime_error("EOF while reading string data");
-    std::string result(reinterpret_cast<const char *>(ptr), len);
-    ptr += len;
-    return result;
-}
-
-uint32_t RPCHandler::readU32(const uint8_t *&ptr, const uint8_t *end) {
-    if (end - ptr < 4)
-        throw std::runtime_error("EOF while reading u32");
-    uint32_t val = decode_uint32(ptr);
-    ptr += 4;
-    return val;
-}
-
 float RPCHandler::readFloat(const uint8_t *&ptr, const uint8_t *end) {
     if (end - ptr < 4)
         throw std::runtime_error("EOF while reading float");
@@ -60,215 +42,114 @@ float RPCHandler::readFloat(const uint8_t *&ptr, const uint8_t *end) {
 // =============================================================
 // Variant Reader
 // =============================================================
-Variant RPCHandler::read_variant(const uint8_t*& ptr, const uint8_t* end) {
-    if (ptr >= end) throw std::runtime_error("EOF while reading variant type");
-
-    Variant v;
-    v.type = static_cast<Variant::Type>(*ptr++);
-
-    switch (v.type) {
-        case Variant::BOOL:
-            if (ptr >= end) throw std::runtime_error("EOF while reading bool");
-            v.b = (*ptr++ != 0);
-            break;
-
-        case Variant::INT:
-            if (end - ptr < 8) throw std::runtime_error("EOF while reading int64");
-            std::memcpy(&v.i, ptr, 8);
-            ptr += 8;
-            break;
-
-        case Variant::FLOAT:
-            if (end - ptr < 8) throw std::runtime_error("EOF while reading double");
-            std::memcpy(&v.f, ptr, 8);
-            ptr += 8;
-            break;
-
-        case Variant::STRING:
-            v.s = readString(ptr, end);
-            break;
-
-        case Variant::VECTOR3:
-            if (end - ptr < 24) throw std::runtime_error("EOF while reading Vector3");
-            double x, y, z;
-            std::memcpy(&x, ptr, 8); ptr += 8;
-            std::memcpy(&y, ptr, 8); ptr += 8;
-            std::memcpy(&z, ptr, 8); ptr += 8;
-            v.v3 = Vector3(x, y, z);
-            break;
-
-        case Variant::ARRAY: {
-            uint32_t count = readU32(ptr, end);
-            v.arr.reserve(count);
-            for (uint32_t i = 0; i < count; ++i)
-                v.arr.push_back(read_variant(ptr, end));
-            break;
-        }
-
-        case Variant::DICTIONARY: {
-            uint32_t count = readU32(ptr, end);
-            for (uint32_t i = 0; i < count; ++i) {
-                std::string key = readString(ptr, end);
-                Variant val = read_variant(ptr, end);
-                v.dict.emplace(std::move(key), std::move(val));
-            }
-            break;
-        }
-
-        default:
-            v.type = Variant::NIL;
-            break;
-    }
-
-    return v;
-}
-
 // Variant para modo byte_only (tipo DEPOIS do valor!)
 Variant RPCHandler::read_variant_byte_only(const uint8_t*& ptr, const uint8_t* end) {
     // No modo byte_only, o formato é: [8 bytes double][1 byte tipo]
     if (end - ptr < 9) throw std::runtime_error("EOF while reading byte_only variant");
     
-    Variant v;
-    
     // Lê 8 bytes como double
     double d;
     std::memcpy(&d, ptr, 8);
     ptr += 8;
     
-    // Lê o tipo (1 byte)
-    v.type = static_cast<Variant::Type>(*ptr++);
-    
-    // Converte conforme o tipo
-    switch (v.type) {
+    // Lê o tipo (1 byte) e converte conforme ele
+    switch (static_cast<Variant::Type>(*ptr++)) {
         case Variant::FLOAT:
-            v.f = d;
-            break;
+            return Variant(d);
         case Variant::INT:
-            v.i = static_cast<int64_t>(d);
-            break;
+            return Variant(static_cast<int64_t>(d));
         case Variant::BOOL:
-            v.b = (d != 0.0);
-            break;
+            return Variant(d != 0.0);
         default:
-            v.type = Variant::NIL;
-            break;
+            return Variant();
     }
-    
-    return v;
 }
 
 // =============================================================
-// Write helpers
+// Register RPC
 // =============================================================
-void RPCHandler::write_u32(std::vector<uint8_t> &buf, uint32_t val) {
-    uint8_t tmp[4];
-    std::memcpy(tmp, &val, 4);
-    buf.insert(buf.end(), tmp, tmp + 4);
-}
-
-void RPCHandler::write_u64(std::vector<uint8_t> &buf, uint64_t val) {
-    uint8_t tmp[8];
-    std::memcpy(tmp, &val, 8);
-    buf.insert(buf.end(), tmp, tmp + 8);
-}
+void RPCHandler::addMethod(uint16_t id, const std::string &method, RPCFunction func, ArgSchema schema,
+                           bool has_schema, RPCWireFunction decoder) {
+    if (id >= methods_.size()) {
+        methods_.resize(static_cast<size_t>(id) + 1);
+    }
 
-void RPCHandler::write_string(std::vector<uint8_t> &buf, const std::string &s) {
-    write_u32(buf, static_cast<uint32_t>(s.size()));
-    buf.insert(buf.end(), s.begin(), s.end());
-}
+    // Reregistrar um nome em outro id libera o id antigo
+    auto it = method_name_to_id_.find(method);
+    if (it != method_name_to_id_.end() && it->second != id) {
+        methods_[it->second] = RPCMethod{};
+    }
 
-void RPCHandler::write_variant(std::vector<uint8_t> &buf, const Variant &v) {
-    buf.push_back(static_cast<uint8_t>(v.type));
-    switch (v.type) {
-        case Variant::BOOL:
-            buf.push_back(v.b ? 1 : 0);
-            break;
-        case Variant::INT:
-            write_u64(buf, v.i);
-            break;
-        case Variant::FLOAT:
-            write_u64(buf, *reinterpret_cast<const uint64_t *>(&v.f));
-            break;
-        case Variant::STRING:
-            write_string(buf, v.s);
-            break;
-        case Variant::VECTOR3:
-            write_u64(buf, *reinterpret_cast<const uint64_t *>(&v.v3.x));
-            write_u64(buf, *reinterpret_cast<const uint64_t *>(&v.v3.y));
-            write_u64(buf, *reinterpret_cast<const uint64_t *>(&v.v3.z));
-            break;
-        case Variant::ARRAY:
-            write_u32(buf, static_cast<uint32_t>(v.arr.size()));
-            for (const auto &a : v.arr)
-                write_variant(buf, a);
-            break;
-        case Variant::DICTIONARY:
-            write_u32(buf, static_cast<uint32_t>(v.dict.size()));
-            for (const auto &[k, val] : v.dict) {
-                write_string(buf, k);
-                write_variant(buf, val);
-            }
-            break;
-        default:
-            break;
+    RPCMethod &entry = methods_[id];
+    if (entry.func && entry.name != method) {
+        method_name_to_id_.erase(entry.name);
     }
+    bool log_calls = entry.func && entry.name == method && entry.log_calls;
+    entry = RPCMethod{method, std::move(func), std::move(schema), has_schema, std::move(decoder), log_calls};
+    method_name_to_id_[method] = id;
+
+    if (id >= next_method_id_) next_method_id_ = id + 1;
 }
 
-// =============================================================
-// Register RPC
-// =============================================================
-void RPCHandler::registerRPC(const std::string &method, RPCFunction func) {
-    uint16_t id = next_method_id_++;
-    rpc_table_[method] = func;
-    rpc_table_by_id_[id] = func;
-    method_id_to_name_[id] = method;
-    method_name_to_id_[method] = id;
+void RPCHandler::registerRPC(const std::string &method, RPCFunction func, ArgSchema schema) {
+    uint16_t id = next_method_id_;
+    bool has_schema = !schema.empty();
+    addMethod(id, method, std::move(func), std::move(schema), has_schema);
     Logger::info("✅ RPC Registered: '" + method + "' -> ID " + std::to_string(id));
 }
 
-void RPCHandler::registerRPCWithId(uint16_t id, const std::string &method, RPCFunction func) {
-    rpc_table_[method] = func;
-    rpc_table_by_id_[id] = func;
-    method_id_to_name_[id] = method;
-    method_name_to_id_[method] = id;
-    if (id >= next_method_id_) next_method_id_ = id + 1;
+void RPCHandler::registerRPCWithId(uint16_t id, const std::string &method, RPCFunction func, ArgSchema schema) {
+    bool has_schema = !schema.empty();
+    addMethod(id, method, std::move(func), std::move(schema), has_schema);
     Logger::info("✅ RPC Registered: '" + method + "' -> ID " + std::to_string(id));
 }
 
-void RPCHandler::registerRPCCallback(const std::string &method, RPCCallback callback) {
-    uint16_t id = next_method_id_++;
-    RPCFunction wrapper = [callback](uint32_t peer_id, const std::string &, const std::string &, const std::vector<Variant> &args) {
+RPCHandler::RPCFunction RPCHandler::wrapCallback(RPCCallback callback) {
+    return [callback = std::move(callback)](uint32_t peer_id, uint32_t, std::string_view,
+                                            const std::vector<Variant> &args) {
         callback(peer_id, args);
     };
-    rpc_table_[method] = wrapper;
-    rpc_table_by_id_[id] = wrapper;
-    rpc_callbacks_[method] = callback;
-    rpc_callbacks_by_id_[id] = callback;
-    method_id_to_name_[id] = method;
-    method_name_to_id_[method] = id;
-    Logger::info("✅ RPC Callback Registered: '" + method + "' -> ID " + std::to_string(id));
+}
+
+void RPCHandler::registerRPCCallback(const std::string &method, RPCCallback callback) {
+    registerRPCCallbackWithId(next_method_id_, method, std::move(callback));
 }
 
 void RPCHandler::registerRPCCallbackWithId(uint16_t id, const std::string &method, RPCCallback callback) {
-    RPCFunction wrapper = [callback](uint32_t peer_id, const std::string &, const std::string &, const std::vector<Variant> &args) {
-        callback(peer_id, args);
-    };
-    rpc_table_[method] = wrapper;
-    rpc_table_by_id_[id] = wrapper;
-    rpc_callbacks_[method] = callback;
-    rpc_callbacks_by_id_[id] = callback;
-    method_id_to_name_[id] = method;
-    method_name_to_id_[method] = id;
-    if (id >= next_method_id_) next_method_id_ = id + 1;
+    // Genérico: aceita qualquer argumento
+    addMethod(id, method, wrapCallback(std::move(callback)), {}, false);
     Logger::info("✅ RPC Callback Registered: '" + method + "' -> ID " + std::to_string(id));
 }
 
+void RPCHandler::registerRPCCallbackWithSchema(uint16_t id, const std::string &method, RPCCallback callback,
+                                               ArgSchema schema) {
+    addMethod(id, method, wrapCallback(std::move(callback)), std::move(schema), true);
+    Logger::info("✅ RPC Callback Registered: '" + method + "' -> ID " + std::to_string(id));
+}
+
+void RPCHandler::registerRPCWithDecoder(uint16_t id, const std::string &method, RPCCallback callback,
+                                        ArgSchema schema, RPCWireFunction decoder) {
+    addMethod(id, method, wrapCallback(std::move(callback)), std::move(schema), true, std::move(decoder));
+    Logger::info("✅ RPC Typed Registered: '" + method + "' -> ID " + std::to_string(id));
+}
+
+bool RPCHandler::setRPCLogging(const std::string &method, bool enabled) {
+    auto it = method_name_to_id_.find(method);
+    if (it == method_name_to_id_.end()) {
+        return false;
+    }
+    methods_[it->second].log_calls = enabled;
+    return true;
+}
+
 // =============================================================
 // Queries
 // =============================================================
-std::string RPCHandler::getMethodNameById(uint16_t id) const {
-    auto it = method_id_to_name_.find(id);
-    return (it != method_id_to_name_.end()) ? it->second : "";
+std::string_view RPCHandler::getMethodNameById(uint16_t id) const {
+    if (id < methods_.size() && methods_[id].func) {
+        return methods_[id].name;
+    }
+    return {};
 }
 
 uint16_t RPCHandler::getMethodIdByName(const std::string &method) const {
@@ -278,46 +159,80 @@ uint16_t RPCHandler::getMethodIdByName(const std::string &method) const {
 
 void RPCHandler::listRegisteredRPCs() const {
     Logger::info("\n========== Registered RPCs ==========");
-    for (const auto &[id, name] : method_id_to_name_) {
-        Logger::info("  ID " + std::to_string(id) + " -> " + name);
+    for (size_t id = 0; id < methods_.size(); ++id) {
+        if (methods_[id].func) {
+            Logger::info("  ID " + std::to_string(id) + " -> " + methods_[id].name);
+        }
     }
     Logger::info("=====================================\n");
 }
 
-// =============================================================
-// Build Godot RPC Packet
-// =============================================================
-std::vector<uint8_t> RPCHandler::buildGodotRPCPacket(const std::string &node_path,
-                                                     const std::string &method,
-                                                     const std::vector<Variant> &args) {
-    std::vector<uint8_t> buf;
-    buf.push_back(0x20);
-    write_string(buf, node_path);
-    write_string(buf, method);
-    write_u32(buf, static_cast<uint32_t>(args.size()));
-    for (const auto &a : args)
-        write_variant(buf, a);
-    return buf;
-}
-
 // =============================================================
 // Process Godot Packet
 // =============================================================
-bool RPCHandler::processGodotPacket(uint32_t peer_id, const std::vector<uint8_t>& data) {
-    if (data.size() < 10 || data[0] != 0x20) {
+bool RPCHandler::processGodotPacket(uint32_t peer_id, std::span<const uint8_t> data) {
+    // Sem tamanho mínimo fixo: chamadas sem argumentos (byte_only) têm
+    // 4 a 7 bytes, e processCall confere o cabeçalho
+    if (data.empty() || data[0] != rpc_wire::kRemoteCall) {
         Logger::error("Invalid RPC packet: size=" + std::to_string(data.size()));
         return false;
     }
 
     // Skip command byte (0x20)
-    const uint8_t* ptr = data.data() + 1;
-    const uint8_t* end = data.data() + data.size();
+    return processCall(peer_id, data.data() + 1, data.data() + data.size());
+}
+
+// Frame [0x21]([varuint len][0x20][chamada])...: cada tamanho é conferido
+// contra o frame antes do dispatch, e a chamada só lê dentro dos seus len
+// bytes. Uma chamada rejeitada não impede as seguintes.
+size_t RPCHandler::processGodotBatch(uint32_t peer_id, std::span<const uint8_t> data) {
+    if (data.empty() || data[0] != rpc_wire::kRemoteCallBatch) {
+        Logger::error("Invalid RPC batch: size=" + std::to_string(data.size()));
+        return 0;
+    }
+
+    BinaryReader reader(data.data() + 1, data.size() - 1);
+    size_t dispatched = 0;
+    while (!reader.empty()) {
+        uint32_t len = 0;
+        const uint8_t* call = nullptr;
+        try {
+            len = reader.readVarUInt();
+            call = reader.readBytes(len);
+        } catch (const std::runtime_error& e) {
+            Logger::error("Malformed RPC batch from peer " + std::to_string(peer_id) + ": " + e.what());
+            break;
+        }
+
+        if (len == 0 || call[0] != rpc_wire::kRemoteCall) {
+            Logger::error("Invalid call in RPC batch from peer " + std::to_string(peer_id));
+            continue;
+        }
+        if (processCall(peer_id, call + 1, call + len)) {
+            ++dispatched;
+        }
+    }
+    return dispatched;
+}
+
+bool RPCHandler::processCall(uint32_t peer_id, const uint8_t* ptr, const uint8_t* end) {
+    if (ptr >= end) {
+        Logger::error("Empty RPC call");
+        return false;
+    }
 
     // Parse meta byte
     uint8_t meta = *ptr++;
-    int node_comp = meta & 0x03;
-    int name_comp = (meta >> 2) & 0x01;
-    bool byte_only = (meta >> 3) & 0x01;
+    int node_comp = meta & rpc_wire::kNodeCompressionMask;
+    int name_comp = (meta >> rpc_wire::kNameCompressionShift) & 0x01;
+    bool byte_only = (meta >> rpc_wire::kByteOnlyShift) & 0x01;
+
+    size_t node_size = node_comp == 0 ? 1 : (node_comp == 1 ? 2 : 4);
+    size_t method_size = name_comp == 0 ? 1 : 2;
+    if (static_cast<size_t>(end - ptr) < node_size + method_size) {
+        Logger::error("Truncated RPC header");
+        return false;
+    }
 
     // Parse node target
     uint32_t node_target = 0;
@@ -340,14 +255,23 @@ bool RPCHandler::processGodotPacket(uint32_t peer_id, const std::vector<uint8_t>
         method_id = decode_uint16(ptr); ptr += 2;
     }
 
-    std::string method_name = getMethodNameById(method_id);
-    if (method_name.empty()) {
+    if (method_id >= methods_.size() || !methods_[method_id].func) {
         Logger::warning("RPC not registered: ID " + std::to_string(method_id));
         return false;
     }
+    const RPCMethod &entry = methods_[method_id];
 
-    // Parse arguments
-    std::vector<Variant> args;
+    // RPCs tipados decodificam direto do pacote (o log precisa dos Variants)
+    if (!byte_only && entry.decoder && !entry.log_calls) {
+        return dispatchDecoded(entry, peer_id, ptr, end);
+    }
+
+    // Parse arguments (no vetor e na arena reaproveitados; movidos para cá
+    // para que um handler que despache outro RPC não os compartilhe)
+    std::vector<Variant> args = std::move(args_scratch_);
+    Arena arena = std::move(args_arena_);
+    args.clear();
+    arena.reset();
 
     if (byte_only) {
         // byte_only mode: [3pad][4float][1type][3pad][4float][1type]...
@@ -366,13 +290,20 @@ bool RPCHandler::processGodotPacket(uint32_t peer_id, const std::vector<uint8_t>
             Variant v;
             if (ptr < end && *ptr <= 7) {
                 // Valid type byte
-                v.type = static_cast<Variant::Type>(*ptr++);
-                
-                switch (v.type) {
-                    case Variant::FLOAT: v.f = static_cast<double>(f); break;
-                    case Variant::INT: v.i = static_cast<int64_t>(f); break;
-                    case Variant::BOOL: v.b = (f != 0.0f); break;
-                    default: v.type = Variant::NIL; break;
+                switch (static_cast<Variant::Type>(*ptr++)) {
+                    case Variant::FLOAT: v = Variant(static_cast<double>(f)); break;
+                    case Variant::INT:
+                        // NaN ou fora de int64 seria UB na conversão
+                        if (!rpc_wire::fitsIntegral<int64_t>(f)) {
+                            Logger::error("byte_only INT argument is not representable as an integer");
+                            args_scratch_ = std::move(args);
+                            args_arena_ = std::move(arena);
+                            return false;
+                        }
+                        v = Variant(static_cast<int64_t>(f));
+                        break;
+                    case Variant::BOOL: v = Variant(f != 0.0f); break;
+                    default: break;
                 }
                 
                 // Skip padding
@@ -381,8 +312,7 @@ bool RPCHandler::processGodotPacket(uint32_t peer_id, const std::vector<uint8_t>
                 }
             } else {
                 // No valid type byte, assume FLOAT
-                v.type = Variant::FLOAT;
-                v.f = static_cast<double>(f);
+                v = Variant(static_cast<double>(f));
             }
             
             args.push_back(v);
@@ -396,6 +326,8 @@ bool RPCHandler::processGodotPacket(uint32_t peer_id, const std::vector<uint8_t>
         // Normal mode: arg_count + typed variants
         if (ptr >= end) {
             Logger::error("Not enough bytes for arg_count");
+            args_scratch_ = std::move(args);
+            args_arena_ = std::move(arena);
             return false;
         }
         
@@ -404,37 +336,109 @@ bool RPCHandler::processGodotPacket(uint32_t peer_id, const std::vector<uint8_t>
 
         for (int i = 0; i < arg_count && ptr < end; ++i) {
             try {
-                Variant v = read_variant(ptr, end);
-                args.push_back(v);
+                args.push_back(rpc_wire::readVariant(ptr, end, arena));
             } catch (const std::exception& e) {
                 Logger::error("Error reading argument " + std::to_string(i) + ": " + e.what());
+                args_scratch_ = std::move(args);
+                args_arena_ = std::move(arena);
                 return false;
             }
         }
     }
 
-    // Log arguments
+    if (!matchesSchema(entry, args)) {
+        args_scratch_ = std::move(args);
+        args_arena_ = std::move(arena);
+        return false;
+    }
+
+    if (entry.log_calls) {
+        logCall(entry, node_target, args);
+    }
+
+    // === CALL RPC ===
+    entry.func(peer_id, node_target, entry.name, args);
+
+    args_scratch_ = std::move(args);
+    args_arena_ = std::move(arena);
+    return true;
+}
+
+// Sem vetor de Variants: os bytes vão direto para os parâmetros do handler.
+// Só DecodeError rejeita o pacote; exceções do handler seguem adiante.
+bool RPCHandler::dispatchDecoded(const RPCMethod &entry, uint32_t peer_id, const uint8_t *ptr,
+                                 const uint8_t *end) {
+    if (ptr >= end) {
+        Logger::error("Not enough bytes for arg_count");
+        return false;
+    }
+    size_t arg_count = *ptr++;
+
+    // Arena movida para cá pelo mesmo motivo que em processGodotPacket
+    Arena arena = std::move(args_arena_);
+    arena.reset();
+
+    bool ok = true;
+    try {
+        entry.decoder(peer_id, ptr, end, arg_count, arena);
+    } catch (const rpc_wire::DecodeError &e) {
+        Logger::warning("RPC '" + entry.name + "' " + e.what());
+        ok = false;
+    }
+
+    args_arena_ = std::move(arena);
+    return ok;
+}
+
+bool RPCHandler::matchesSchema(const RPCMethod &entry, const std::vector<Variant> &args) const {
+    if (!entry.has_schema) {
+        return true;
+    }
+
+    if (args.size() != entry.schema.size()) {
+        Logger::warning("RPC '" + entry.name + "' expected " + std::to_string(entry.schema.size()) +
+                        " args, got " + std::to_string(args.size()));
+        return false;
+    }
+
+    for (size_t i = 0; i < args.size(); ++i) {
+        // INT e FLOAT chegam trocados conforme o cliente serializa números;
+        // NIL no esquema aceita qualquer tipo
+        Variant::Type expected = entry.schema[i];
+        Variant::Type actual = args[i].type;
+        if (expected == Variant::NIL) {
+            continue;
+        }
+        bool numeric = (expected == Variant::INT || expected == Variant::FLOAT) &&
+                       (actual == Variant::INT || actual == Variant::FLOAT);
+        if (actual != expected && !numeric) {
+            Logger::warning("RPC '" + entry.name + "' arg " + std::to_string(i) + " has type " +
+                            std::to_string(actual) + ", expected " + std::to_string(expected));
+            return false;
+        }
+        // FLOAT num parâmetro inteiro: NaN, infinito ou fora de int64 não convertem
+        if (expected == Variant::INT && actual == Variant::FLOAT &&
+            !rpc_wire::fitsIntegral<int64_t>(args[i].asFloat())) {
+            Logger::warning("RPC '" + entry.name + "' arg " + std::to_string(i) +
+                            " is not representable as an integer");
+            return false;
+        }
+    }
+    return true;
+}
+
+void RPCHandler::logCall(const RPCMethod &entry, uint32_t node_id, const std::vector<Variant> &args) const {
+    Logger::info("CALLING RPC: '" + entry.name + "' on node " + std::to_string(node_id));
     for (size_t i = 0; i < args.size(); ++i) {
         std::string s;
         switch (args[i].type) {
-            case Variant::FLOAT:  s = "FLOAT: "  + std::to_string(args[i].f); break;
-            case Variant::INT:    s = "INT: "    + std::to_string(args[i].i); break;
-            case Variant::BOOL:   s = "BOOL: "   + std::string(args[i].b ? "true" : "false"); break;
-            case Variant::STRING: s = "STRING: '" + args[i].s + "'"; break;
+            case Variant::FLOAT:  s = "FLOAT: "  + std::to_string(args[i].asFloat()); break;
+            case Variant::INT:    s = "INT: "    + std::to_string(args[i].asInt()); break;
+            case Variant::BOOL:   s = "BOOL: "   + std::string(args[i].asBool() ? "true" : "false"); break;
+            case Variant::STRING: s = "STRING: '" + std::string(args[i].asString()) + "'"; break;
             case Variant::NIL:    s = "NIL"; break;
             default:              s = "Type " + std::to_string((int)args[i].type); break;
         }
         Logger::info("  Arg[" + std::to_string(i) + "]: " + s);
     }
-
-    // === CALL RPC ===
-    auto it = rpc_table_by_id_.find(method_id);
-    if (it != rpc_table_by_id_.end()) {
-        Logger::info("CALLING RPC: '" + method_name + "' on node " + std::to_string(node_target));
-        it->second(peer_id, "node_" + std::to_string(node_target), method_name, args);
-        return true;
-    }
-
-    Logger::warning("RPC not registered: ID " + std::to_string(method_id) + " ('" + method_name + "')");
-    return false;
-}
\ No newline at end of file
+}
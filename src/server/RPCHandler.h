@@ -3,11 +3,14 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 #include <functional>
 #include <memory>
-#include "utils/Structs.h"
+#include <span>
+#include "server/Variant.h"
+#include "utils/Arena.h"
 
 #define NODE_ID_COMPRESSION_SHIFT 4
 #define NAME_ID_COMPRESSION_SHIFT 6
@@ -17,69 +20,60 @@
 #define NAME_ID_COMPRESSION_FLAG (1 << NAME_ID_COMPRESSION_SHIFT)
 #define BYTE_ONLY_OR_NO_ARGS_FLAG (1 << BYTE_ONLY_OR_NO_ARGS_SHIFT)
 
-struct Variant
-{
-    enum Type : uint8_t
-    {
-        NIL = 0,
-        BOOL = 1,
-        INT = 2,
-        FLOAT = 3,
-        STRING = 4,
-        VECTOR3 = 5,
-        ARRAY = 6,
-        DICTIONARY = 7
-    } type = NIL;
-
-    bool b = false;
-    int64_t i = 0;
-    double f = 0.0;
-    std::string s;
-    Vector3 v3;
-    std::vector<Variant> arr;
-    std::unordered_map<std::string, Variant> dict;
-
-    Variant() : type(NIL) {}
-    Variant(bool val) : type(BOOL), b(val) {}
-    Variant(int64_t val) : type(INT), i(val) {}
-    Variant(double val) : type(FLOAT), f(val) {}
-    Variant(const std::string &val) : type(STRING), s(val) {}
-    Variant(const char *val) : type(STRING), s(val) {}
-    Variant(const Vector3 &val) : type(VECTOR3), v3(val) {}
-    Variant(const std::vector<Variant> &val) : type(ARRAY), arr(val) {}
-    Variant(const std::unordered_map<std::string, Variant> &val) : type(DICTIONARY), dict(val) {}
-};
-
 class RPCHandler
 {
 public:
+    // node_id é o alvo do RPC como o Godot o envia (id de cache do path);
+    // method aponta para o nome registrado e vale enquanto o RPC existir
     using RPCFunction = std::function<void(uint32_t sender_id,
-                                           const std::string &node_path,
-                                           const std::string &method,
+                                           uint32_t node_id,
+                                           std::string_view method,
                                            const std::vector<Variant> &args)>;
 
     // Callback simplificado para RPCRegistry
     using RPCCallback = std::function<void(uint32_t peer_id, const std::vector<Variant>& args)>;
 
+    // Decodifica os argumentos direto do pacote (arg_count já lido) e
+    // chama o handler; lança rpc_wire::DecodeError se não casarem
+    using RPCWireFunction = std::function<void(uint32_t peer_id, const uint8_t *args, const uint8_t *end,
+                                               size_t arg_count, Arena &arena)>;
+
+    // Tipos esperados dos argumentos. Em registerRPC vazio = não valida;
+    // nos registros com esquema (tipados) vazio = nenhum argumento.
+    using ArgSchema = std::vector<Variant::Type>;
+
     RPCHandler() = default;
     ~RPCHandler() = default;
 
     // ========== Registro de RPCs ==========
     
     // Registra RPC por nome (auto-incrementa ID)
-    void registerRPC(const std::string &method, RPCFunction func);
+    void registerRPC(const std::string &method, RPCFunction func, ArgSchema schema = {});
     
     // Registra RPC com ID específico (para sincronizar com Godot)
-    void registerRPCWithId(uint16_t id, const std::string &method, RPCFunction func);
+    void registerRPCWithId(uint16_t id, const std::string &method, RPCFunction func, ArgSchema schema = {});
     
     // Registra RPC callback simplificado (usado pelo RPCRegistry)
     void registerRPCCallback(const std::string &method, RPCCallback callback);
     void registerRPCCallbackWithId(uint16_t id, const std::string &method, RPCCallback callback);
+    void registerRPCCallbackWithSchema(uint16_t id, const std::string &method, RPCCallback callback,
+                                       ArgSchema schema);
+
+    // RPC tipado: 'decoder' atende os pacotes normais sem montar Variants;
+    // 'callback' + 'schema' atendem o modo byte_only e o log de chamadas
+    void registerRPCWithDecoder(uint16_t id, const std::string &method, RPCCallback callback,
+                                ArgSchema schema, RPCWireFunction decoder);
+
+    // Id que o próximo registro sem id explícito recebe
+    uint16_t nextMethodId() const { return next_method_id_; }
+
+    // Loga cada chamada do método com seus argumentos (desligado por padrão)
+    bool setRPCLogging(const std::string &method, bool enabled);
 
     // ========== Consultas ==========
     
-    // Busca nome do método pelo ID
-    std::string getMethodNameById(uint16_t id) const;
+    // Busca nome do método pelo ID ("" se não registrado)
+    std::string_view getMethodNameById(uint16_t id) const;
     
     // Busca ID do método pelo nome
     uint16_t getMethodIdByName(const std::string& method) const;
@@ -89,37 +83,48 @@ public:
 
     // ========== Processamento ==========
     
-    bool processGodotPacket(uint32_t peer_id, const std::vector<uint8_t> &data);
-
-    std::vector<uint8_t> buildGodotRPCPacket(const std::string &node_path,
-                                             const std::string &method,
-                                             const std::vector<Variant> &args);
+    bool processGodotPacket(uint32_t peer_id, std::span<const uint8_t> data);
+    // Várias chamadas num frame NETWORK_COMMAND_REMOTE_CALL_BATCH; retorna
+    // quantas foram despachadas
+    size_t processGodotBatch(uint32_t peer_id, std::span<const uint8_t> data);
 
 private:
-    // Tabelas de mapeamento
-    std::unordered_map<std::string, RPCFunction> rpc_table_;         // nome -> callback completo
-    std::unordered_map<uint16_t, RPCFunction> rpc_table_by_id_;     // id -> callback completo
-    std::unordered_map<std::string, RPCCallback> rpc_callbacks_;     // nome -> callback simples
-    std::unordered_map<uint16_t, RPCCallback> rpc_callbacks_by_id_; // id -> callback simples
-    std::unordered_map<uint16_t, std::string> method_id_to_name_;   // id -> nome
+    // Entrada da tabela de dispatch, indexada pelo id do método
+    struct RPCMethod {
+        std::string name;
+        RPCFunction func;       // vazio = id livre
+        ArgSchema schema;
+        bool has_schema = false;   // valida contagem e tipos, mesmo com schema vazio
+        RPCWireFunction decoder;   // opcional (RPCs tipados)
+        bool log_calls = false;
+    };
+
+    // Uma chamada a partir do byte meta (sem o 0x20)
+    bool processCall(uint32_t peer_id, const uint8_t *ptr, const uint8_t *end);
+    void addMethod(uint16_t id, const std::string &method, RPCFunction func, ArgSchema schema,
+                   bool has_schema, RPCWireFunction decoder = {});
+    static RPCFunction wrapCallback(RPCCallback callback);
+    bool dispatchDecoded(const RPCMethod &entry, uint32_t peer_id, const uint8_t *ptr, const uint8_t *end);
+    bool matchesSchema(const RPCMethod &entry, const std::vector<Variant> &args) const;
+    void logCall(const RPCMethod &entry, uint32_t node_id, const std::vector<Variant> &args) const;
+
+    // O hot path só indexa este vetor; o mapa por nome serve ao registro
+    std::vector<RPCMethod> methods_;
     std::unordered_map<std::string, uint16_t> method_name_to_id_;   // nome -> id
     
     uint16_t next_method_id_ = 0;
 
+    // Argumentos reaproveitados entre chamadas (capacidade preservada).
+    // Arrays e dicionários vão para a arena; strings longas apontam para
+    // o próprio pacote.
+    std::vector<Variant> args_scratch_;
+    Arena args_arena_;
+
     // decoders
     uint32_t decode_uint32(const uint8_t *p_arr);
     uint16_t decode_uint16(const uint8_t *p_arr);
 
-    // read helpers
-    std::string readString(const uint8_t*& ptr, const uint8_t* end);
-    uint32_t readU32(const uint8_t*& ptr, const uint8_t* end);
+    // read helpers (formato normal em server/RPCWire.h)
     float readFloat(const uint8_t*& ptr, const uint8_t* end);
-    Variant read_variant(const uint8_t*& ptr, const uint8_t* end);
     Variant read_variant_byte_only(const uint8_t*& ptr, const uint8_t* end);
-
-    // write helpers
-    void write_u32(std::vector<uint8_t> &buf, uint32_t val);
-    void write_u64(std::vector<uint8_t> &buf, uint64_t val);
-    void write_string(std::vector<uint8_t> &buf, const std::string &s);
-    void write_variant(std::vector<uint8_t> &buf, const Variant &v);
 };
\ No newline at end of file
@@ -3,10 +3,15 @@
 #define RPC_REGISTRY_H
 
 #include "server/RPCHandler.h"
+#include "server/RPCWire.h"
 #include "utils/Logger.h"
 #include <functional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <tuple>
 #include <vector>
+#include <type_traits>
 #include <utility>
 
 // ========== Template helpers FORA da classe ==========
@@ -16,40 +21,63 @@ template<typename T>
 T get_arg_helper(const Variant& v);
 
 // Especializações
+// INT e FLOAT são aceitos um no lugar do outro (ver RPCHandler::matchesSchema)
+inline double variant_as_double(const Variant& v) {
+    return v.type == Variant::INT ? static_cast<double>(v.asInt()) : v.asFloat();
+}
+
+// O esquema já recusa FLOATs que não cabem em int64; a conversão checada
+// só protege chamadas fora do dispatch validado
+inline int64_t variant_as_int(const Variant& v) {
+    return v.type == Variant::FLOAT ? rpc_wire::integralFromDouble<int64_t>(v.asFloat(), 0) : v.asInt();
+}
+
 template<> inline float get_arg_helper<float>(const Variant& v) { 
-    return static_cast<float>(v.f); 
+    return static_cast<float>(variant_as_double(v)); 
 }
 
 template<> inline double get_arg_helper<double>(const Variant& v) { 
-    return v.f; 
+    return variant_as_double(v); 
 }
 
 template<> inline int get_arg_helper<int>(const Variant& v) { 
-    return static_cast<int>(v.i); 
+    return static_cast<int>(variant_as_int(v)); 
 }
 
 template<> inline int64_t get_arg_helper<int64_t>(const Variant& v) { 
-    return v.i; 
+    return variant_as_int(v); 
 }
 
 template<> inline bool get_arg_helper<bool>(const Variant& v) { 
-    return v.b; 
+    return v.asBool(); 
 }
 
 template<> inline std::string get_arg_helper<std::string>(const Variant& v) { 
-    return v.s; 
+    return std::string(v.asString()); 
+}
+
+// Sem cópia: válido só durante a chamada do RPC
+template<> inline std::string_view get_arg_helper<std::string_view>(const Variant& v) { 
+    return v.asString(); 
 }
 
 template<> inline Vector3 get_arg_helper<Vector3>(const Variant& v) { 
-    return v.v3; 
+    return v.asVector3(); 
 }
 
-template<> inline std::vector<Variant> get_arg_helper<std::vector<Variant>>(const Variant& v) {
-    return v.arr;
+// Arrays e dicionários referenciam a arena do dispatch: válidos só
+// durante a chamada do RPC
+template<> inline std::span<const Variant> get_arg_helper<std::span<const Variant>>(const Variant& v) {
+    return v.asArray();
 }
 
-template<> inline std::unordered_map<std::string, Variant> get_arg_helper<std::unordered_map<std::string, Variant>>(const Variant& v) {
-    return v.dict;
+template<> inline std::span<const VariantPair> get_arg_helper<std::span<const VariantPair>>(const Variant& v) {
+    return v.asDictionary();
+}
+
+// Qualquer tipo (esquema NIL)
+template<> inline Variant get_arg_helper<Variant>(const Variant& v) {
+    return v;
 }
 
 // ========== Classe RPCRegistry ==========
@@ -75,36 +103,28 @@ public:
 
     // ========== Registro Type-Safe (tipos específicos) ==========
     
+    // Pacotes normais são decodificados direto do wire nos tipos de Args
+    // (strings como std::string_view não copiam). O callback por Variants
+    // fica para o modo byte_only e para o log de chamadas; nele o esquema
+    // derivado de Args é validado antes do dispatch.
     template<typename... Args>
     void registerRPCTyped(const std::string& method_name, 
                           std::function<void(uint32_t, Args...)> callback) {
-        registerRPC(method_name, 
-            [callback, method_name](uint32_t peer_id, const std::vector<Variant>& args) {
-                constexpr size_t expected = sizeof...(Args);
-                if (args.size() != expected) {
-                    Logger::error("RPC '" + method_name + "' expected " + 
-                                std::to_string(expected) + " args, got " + 
-                                std::to_string(args.size()));
-                    return;
-                }
-                call_with_args<Args...>(callback, peer_id, args, std::index_sequence_for<Args...>{});
-            }
-        );
+        registerRPCTypedWithId<Args...>(handler_.nextMethodId(), method_name, std::move(callback));
     }
 
     template<typename... Args>
     void registerRPCTypedWithId(uint16_t id, const std::string& method_name,
                                std::function<void(uint32_t, Args...)> callback) {
-        registerRPCWithId(id, method_name,
-            [callback, method_name](uint32_t peer_id, const std::vector<Variant>& args) {
-                constexpr size_t expected = sizeof...(Args);
-                if (args.size() != expected) {
-                    Logger::error("RPC '" + method_name + "' expected " + 
-                                std::to_string(expected) + " args, got " + 
-                                std::to_string(args.size()));
-                    return;
-                }
+        handler_.registerRPCWithDecoder(id, method_name,
+            [callback](uint32_t peer_id, const std::vector<Variant>& args) mutable {
                 call_with_args<Args...>(callback, peer_id, args, std::index_sequence_for<Args...>{});
+            },
+            {rpc_wire::expectedType<std::decay_t<Args>>()...},
+            [callback](uint32_t peer_id, const uint8_t* ptr, const uint8_t* end, size_t arg_count,
+                       Arena& arena) mutable {
+                std::apply([&](auto&&... args) { callback(peer_id, std::forward<decltype(args)>(args)...); },
+                           rpc_wire::readArgs<std::decay_t<Args>...>(ptr, end, arg_count, arena));
             }
         );
     }
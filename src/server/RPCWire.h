@@ -0,0 +1,343 @@
+// include/server/RPCWire.h
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "server/Variant.h"
+#include "utils/Arena.h"
+#include "utils/BinaryStream.h"
+
+// Formato dos RPCs Godot: [0x20][meta][node_id 1/2/4 bytes][method_id 1/2 bytes]
+// [u8 argc][argumentos], cada argumento como [u8 tipo][valor] (inteiros
+// little-endian, strings com u32 de tamanho, Vector3 como três doubles).
+// Usado pelo RPCHandler para montar Variants, pelos RPCs tipados, que
+// decodificam direto nos tipos dos parâmetros, e pelos envios de RPC.
+namespace rpc_wire {
+
+// Primeiro byte do pacote: uma chamada, ou várias em
+// [0x21]([varuint len][0x20][chamada])..., como o envelope BATCH
+constexpr uint8_t kRemoteCall = 0x20;
+constexpr uint8_t kRemoteCallBatch = 0x21;
+
+// Byte meta: bits 0-1 compressão do node (0 = u8, 1 = u16, 2/3 = u32),
+// bit 2 compressão do método (0 = u8, 1 = u16), bit 3 byte_only
+constexpr uint8_t kNodeCompressionMask = 0x03;
+constexpr uint8_t kNameCompressionShift = 2;
+constexpr uint8_t kByteOnlyShift = 3;
+
+// Pacote truncado ou argumento do tipo errado. Separada das exceções dos
+// handlers para que só erros de decodificação rejeitem o pacote.
+class DecodeError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+inline uint32_t readU32(const uint8_t*& ptr, const uint8_t* end) {
+    if (end - ptr < 4) throw DecodeError("EOF while reading u32");
+    uint32_t v = 0;
+    for (int i = 0; i < 4; ++i)
+        v |= static_cast<uint32_t>(ptr[i]) << (i * 8);
+    ptr += 4;
+    return v;
+}
+
+inline double readDouble(const uint8_t*& ptr, const uint8_t* end) {
+    if (end - ptr < 8) throw DecodeError("EOF while reading double");
+    double v;
+    std::memcpy(&v, ptr, 8);
+    ptr += 8;
+    return v;
+}
+
+inline int64_t readI64(const uint8_t*& ptr, const uint8_t* end) {
+    if (end - ptr < 8) throw DecodeError("EOF while reading int64");
+    int64_t v;
+    std::memcpy(&v, ptr, 8);
+    ptr += 8;
+    return v;
+}
+
+// Aponta para os bytes do pacote, sem cópia
+inline std::string_view readString(const uint8_t*& ptr, const uint8_t* end) {
+    uint32_t len = readU32(ptr, end);
+    if (len > static_cast<uint32_t>(end - ptr)) throw DecodeError("EOF while reading string data");
+    std::string_view s(reinterpret_cast<const char*>(ptr), len);
+    ptr += len;
+    return s;
+}
+
+inline Vector3 readVector3(const uint8_t*& ptr, const uint8_t* end) {
+    if (end - ptr < 24) throw DecodeError("EOF while reading Vector3");
+    double x = readDouble(ptr, end);
+    double y = readDouble(ptr, end);
+    double z = readDouble(ptr, end);
+    return Vector3{static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)};
+}
+
+inline Variant::Type readType(const uint8_t*& ptr, const uint8_t* end) {
+    if (ptr >= end) throw DecodeError("EOF while reading variant type");
+    return static_cast<Variant::Type>(*ptr++);
+}
+
+// Valor de um tipo já lido. Strings longas referenciam o pacote; arrays e
+// dicionários são alocados na arena. Ambos precisam viver até o fim do
+// dispatch.
+inline Variant readValue(Variant::Type type, const uint8_t*& ptr, const uint8_t* end, Arena& arena) {
+    switch (type) {
+        case Variant::BOOL:
+            if (ptr >= end) throw DecodeError("EOF while reading bool");
+            return Variant(*ptr++ != 0);
+
+        case Variant::INT:
+            return Variant(readI64(ptr, end));
+
+        case Variant::FLOAT:
+            return Variant(readDouble(ptr, end));
+
+        case Variant::STRING:
+            return Variant::stringView(readString(ptr, end));
+
+        case Variant::VECTOR3:
+            return Variant(readVector3(ptr, end));
+
+        case Variant::ARRAY: {
+            uint32_t count = readU32(ptr, end);
+            // Cada item ocupa ao menos 1 byte: barra contagens forjadas
+            if (count > static_cast<uint32_t>(end - ptr))
+                throw DecodeError("Array count exceeds packet size");
+            Variant* items = arena.allocate<Variant>(count);
+            for (uint32_t i = 0; i < count; ++i)
+                items[i] = readValue(readType(ptr, end), ptr, end, arena);
+            return Variant::array(std::span<const Variant>(items, count));
+        }
+
+        case Variant::DICTIONARY: {
+            uint32_t count = readU32(ptr, end);
+            if (count > static_cast<uint32_t>(end - ptr))
+                throw DecodeError("Dictionary count exceeds packet size");
+            VariantPair* pairs = arena.allocate<VariantPair>(count);
+            for (uint32_t i = 0; i < count; ++i) {
+                pairs[i].key = Variant::stringView(readString(ptr, end));
+                pairs[i].value = readValue(readType(ptr, end), ptr, end, arena);
+            }
+            return Variant::dictionary(std::span<const VariantPair>(pairs, count));
+        }
+
+        default:
+            return Variant();
+    }
+}
+
+inline Variant readVariant(const uint8_t*& ptr, const uint8_t* end, Arena& arena) {
+    Variant::Type type = readType(ptr, end);
+    return readValue(type, ptr, end, arena);
+}
+
+// ========== Decodificação tipada ==========
+
+// Tipo de Variant esperado para cada tipo C++ (NIL = aceita qualquer um)
+template<typename T>
+constexpr Variant::Type expectedType() {
+    if constexpr (std::is_same_v<T, bool>) return Variant::BOOL;
+    else if constexpr (std::is_integral_v<T>) return Variant::INT;
+    else if constexpr (std::is_floating_point_v<T>) return Variant::FLOAT;
+    else if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>) return Variant::STRING;
+    else if constexpr (std::is_same_v<T, Vector3>) return Variant::VECTOR3;
+    else if constexpr (std::is_same_v<T, std::span<const Variant>>) return Variant::ARRAY;
+    else if constexpr (std::is_same_v<T, std::span<const VariantPair>>) return Variant::DICTIONARY;
+    else if constexpr (std::is_same_v<T, Variant>) return Variant::NIL;
+    else static_assert(sizeof(T) == 0, "Unsupported RPC argument type");
+}
+
+[[noreturn]] inline void throwTypeMismatch(size_t index, Variant::Type actual, Variant::Type expected) {
+    throw DecodeError("arg " + std::to_string(index) + " has type " + std::to_string(actual) +
+                      ", expected " + std::to_string(expected));
+}
+
+// Se static_cast<T>(v) é definido: falso para NaN, infinito e valores
+// cuja parte inteira não cabe em T
+template<typename T>
+bool fitsIntegral(double v) {
+    // 2^digits: primeiro valor acima de max(), exato em double
+    constexpr double upper = 2.0 * static_cast<double>(std::numeric_limits<T>::max() / 2 + 1);
+    constexpr double lower = static_cast<double>(std::numeric_limits<T>::min());
+    double truncated = std::trunc(v);
+    return truncated >= lower && truncated < upper;
+}
+
+// FLOAT recebido num parâmetro inteiro; o que não cabe em T vira DecodeError
+template<typename T>
+T integralFromDouble(double v, size_t index) {
+    if (!fitsIntegral<T>(v)) {
+        throw DecodeError("arg " + std::to_string(index) + " is not representable as an integer");
+    }
+    return static_cast<T>(v);
+}
+
+// INT recebido num parâmetro inteiro mais estreito: não trunca
+template<typename T>
+T integralFromInt64(int64_t v, size_t index) {
+    bool fits;
+    if constexpr (std::is_signed_v<T>) {
+        fits = v >= static_cast<int64_t>(std::numeric_limits<T>::min()) &&
+               v <= static_cast<int64_t>(std::numeric_limits<T>::max());
+    } else {
+        fits = v >= 0 && static_cast<uint64_t>(v) <= static_cast<uint64_t>(std::numeric_limits<T>::max());
+    }
+    if (!fits) {
+        throw DecodeError("arg " + std::to_string(index) + " is out of range for its parameter");
+    }
+    return static_cast<T>(v);
+}
+
+// Lê um argumento direto no tipo T. INT e FLOAT são aceitos um no lugar
+// do outro, como em RPCHandler::matchesSchema.
+template<typename T>
+T readArg(const uint8_t*& ptr, const uint8_t* end, Arena& arena, size_t index) {
+    Variant::Type type = readType(ptr, end);
+    constexpr Variant::Type expected = expectedType<T>();
+
+    if constexpr (expected == Variant::NIL) {
+        return readValue(type, ptr, end, arena);
+    } else if constexpr (expected == Variant::INT || expected == Variant::FLOAT) {
+        if (type == Variant::INT) {
+            if constexpr (expected == Variant::INT) return integralFromInt64<T>(readI64(ptr, end), index);
+            else return static_cast<T>(readI64(ptr, end));
+        }
+        if (type == Variant::FLOAT) {
+            if constexpr (expected == Variant::INT) return integralFromDouble<T>(readDouble(ptr, end), index);
+            else return static_cast<T>(readDouble(ptr, end));
+        }
+        throwTypeMismatch(index, type, expected);
+    } else {
+        if (type != expected) throwTypeMismatch(index, type, expected);
+
+        if constexpr (expected == Variant::BOOL) {
+            if (ptr >= end) throw DecodeError("EOF while reading bool");
+            return *ptr++ != 0;
+        } else if constexpr (expected == Variant::STRING) {
+            return T(readString(ptr, end));
+        } else if constexpr (expected == Variant::VECTOR3) {
+            return readVector3(ptr, end);
+        } else if constexpr (expected == Variant::ARRAY) {
+            return readValue(type, ptr, end, arena).asArray();
+        } else {
+            return readValue(type, ptr, end, arena).asDictionary();
+        }
+    }
+}
+
+// Decodifica todos os argumentos na ordem de Args. A lista entre chaves
+// garante a avaliação da esquerda para a direita.
+template<typename... Args, size_t... Is>
+std::tuple<Args...> readArgs(const uint8_t*& ptr, const uint8_t* end, Arena& arena, std::index_sequence<Is...>) {
+    return std::tuple<Args...>{readArg<Args>(ptr, end, arena, Is)...};
+}
+
+template<typename... Args>
+std::tuple<Args...> readArgs(const uint8_t*& ptr, const uint8_t* end, size_t arg_count, Arena& arena) {
+    if (arg_count != sizeof...(Args)) {
+        throw DecodeError("expected " + std::to_string(sizeof...(Args)) + " args, got " +
+                          std::to_string(arg_count));
+    }
+    return readArgs<Args...>(ptr, end, arena, std::index_sequence_for<Args...>{});
+}
+
+// ========== Escrita ==========
+
+inline void writeDouble(BinaryWriter& out, double v) {
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    out.writeU64(bits);
+}
+
+inline void writeString(BinaryWriter& out, std::string_view s) {
+    out.writeU32(static_cast<uint32_t>(s.size()));
+    out.writeBytes(s.data(), s.size());
+}
+
+// Mesmo layout que readVariant
+inline void writeVariant(BinaryWriter& out, const Variant& v) {
+    out.writeU8(static_cast<uint8_t>(v.type));
+    switch (v.type) {
+        case Variant::BOOL:
+            out.writeU8(v.asBool() ? 1 : 0);
+            break;
+        case Variant::INT:
+            out.writeU64(static_cast<uint64_t>(v.asInt()));
+            break;
+        case Variant::FLOAT:
+            writeDouble(out, v.asFloat());
+            break;
+        case Variant::STRING:
+            writeString(out, v.asString());
+            break;
+        case Variant::VECTOR3:
+            writeDouble(out, v.asVector3().x);
+            writeDouble(out, v.asVector3().y);
+            writeDouble(out, v.asVector3().z);
+            break;
+        case Variant::ARRAY:
+            out.writeU32(static_cast<uint32_t>(v.asArray().size()));
+            for (const Variant& item : v.asArray())
+                writeVariant(out, item);
+            break;
+        case Variant::DICTIONARY:
+            out.writeU32(static_cast<uint32_t>(v.asDictionary().size()));
+            for (const auto& [key, value] : v.asDictionary()) {
+                writeString(out, key.asString());
+                writeVariant(out, value);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// Chamada comprimida, sem o byte 0x20 (ver RPCHandler::processGodotPacket).
+// Node e método usam o menor tamanho que os comporta; sem argumentos vai
+// em modo byte_only, sem a contagem, como o Godot envia. false se houver
+// mais de 255 argumentos.
+inline bool writeCall(BinaryWriter& out, uint32_t node_id, uint16_t method_id, std::span<const Variant> args) {
+    if (args.size() > 0xFF) {
+        return false;
+    }
+
+    uint8_t node_comp = node_id <= 0xFF ? 0 : (node_id <= 0xFFFF ? 1 : 2);
+    uint8_t name_comp = method_id <= 0xFF ? 0 : 1;
+    uint8_t byte_only = args.empty() ? 1 : 0;
+    out.writeU8(static_cast<uint8_t>(node_comp | (name_comp << kNameCompressionShift) |
+                                     (byte_only << kByteOnlyShift)));
+
+    if (node_comp == 0) {
+        out.writeU8(static_cast<uint8_t>(node_id));
+    } else if (node_comp == 1) {
+        out.writeU16(static_cast<uint16_t>(node_id));
+    } else {
+        out.writeU32(node_id);
+    }
+
+    if (name_comp == 0) {
+        out.writeU8(static_cast<uint8_t>(method_id));
+    } else {
+        out.writeU16(method_id);
+    }
+
+    if (!byte_only) {
+        out.writeU8(static_cast<uint8_t>(args.size()));
+        for (const Variant& arg : args)
+            writeVariant(out, arg);
+    }
+    return true;
+}
+
+}
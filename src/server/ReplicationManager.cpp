@@ -0,0 +1,294 @@
+// src/server/ReplicationManager.cpp
+#include "server/ReplicationManager.h"
+#include "server/Player.h"
+#include "server/World.h"
+#include "utils/BinaryStream.h"
+#include <algorithm>
+#include <limits>
+
+ReplicationManager::ReplicationManager(float default_view_radius)
+    : default_view_radius_(default_view_radius) {}
+
+void ReplicationManager::captureWorld(const PeerTable<std::shared_ptr<Player>>& players) {
+    ++sequence_;
+
+    world_players_.clear();
+    world_players_.reserve(players.size());
+    for (const auto& [id, player] : players) {
+        world_players_.push_back(player.get());
+    }
+    std::sort(world_players_.begin(), world_players_.end(),
+              [](const Player* a, const Player* b) { return a->getPeerId() < b->getPeerId(); });
+
+    world_.resize(world_players_.size());
+    for (size_t i = 0; i < world_players_.size(); ++i) {
+        const Player* player = world_players_[i];
+        const Vector3& pos = player->getPosition();
+
+        EntityState& state = world_[i];
+        state.id = player->getPeerId();
+        state.qx = EntityState::quantize(pos.x);
+        state.qy = EntityState::quantize(pos.y);
+        state.qz = EntityState::quantize(pos.z);
+        // Fora da faixa de int16 satura em vez de dar a volta (vida negativa)
+        constexpr int kMin = std::numeric_limits<int16_t>::min();
+        constexpr int kMax = std::numeric_limits<int16_t>::max();
+        state.health = static_cast<int16_t>(std::clamp(player->getHealth(), kMin, kMax));
+        state.level = static_cast<int16_t>(std::clamp(player->getLevel(), kMin, kMax));
+    }
+}
+
+const std::vector<EntityState>* ReplicationManager::findBaseline(const ClientState& client) const {
+    if (client.acked_sequence == 0) {
+        return nullptr;
+    }
+    const SentSnapshot& snap = client.history[client.acked_sequence % kHistorySize];
+    return snap.sequence == client.acked_sequence ? &snap.entities : nullptr;
+}
+
+static bool lessById(const EntityState& s, uint32_t id) {
+    return s.id < id;
+}
+
+const EntityState* ReplicationManager::findEntity(uint32_t id) const {
+    auto it = std::lower_bound(world_.begin(), world_.end(), id, lessById);
+    return (it != world_.end() && it->id == id) ? &*it : nullptr;
+}
+
+std::string_view ReplicationManager::lookupName(uint32_t id) const {
+    const EntityState* state = findEntity(id);
+    if (!state) {
+        return {};
+    }
+    return world_players_[static_cast<size_t>(state - world_.data())]->getUsername();
+}
+
+void ReplicationManager::computeRelevantSet(const ClientState& client, const Vector3& observer,
+                                            SpatialGrid& grid, uint32_t self_id) {
+    float radius = client.view_radius > 0.0f ? client.view_radius : default_view_radius_;
+    float exit_radius = radius * kExitHysteresis;
+
+    // O que o cliente provavelmente já tem: o último snapshot enviado
+    const std::vector<EntityState>* previous = nullptr;
+    const SentSnapshot& last = client.history[client.last_sent_sequence % kHistorySize];
+    if (client.last_sent_sequence != 0 && last.sequence == client.last_sent_sequence) {
+        previous = &last.entities;
+    }
+
+    relevant_.clear();
+    bool has_self = false;
+
+    // Grid e listas de vizinhos já filtram pelo raio de saída nas suas
+    // posições; a histerese usa as posições quantizadas do snapshot. A
+    // lista só vale se foi calculada em volta do próprio observer (o
+    // jogador está no grid e não se moveu desde o cálculo).
+    size_t index = NeighborLists::kNoIndex;
+    if (neighbors_ && neighbors_->radius >= exit_radius) {
+        index = neighbors_->indexOf(self_id);
+        if (index != NeighborLists::kNoIndex &&
+            (neighbors_->xs[index] != observer.x || neighbors_->zs[index] != observer.z)) {
+            index = NeighborLists::kNoIndex;
+        }
+    }
+
+    std::span<const uint32_t> nearby;
+    if (index != NeighborLists::kNoIndex) {
+        nearby = neighbors_->at(index);
+    } else {
+        grid.queryRadiusInto(observer.x, observer.z, exit_radius, nearby_);
+        nearby = nearby_;
+    }
+    for (uint32_t id : nearby) {
+        const EntityState* state = findEntity(id);
+        if (!state) {
+            continue;
+        }
+
+        float dx = EntityState::dequantize(state->qx) - observer.x;
+        float dz = EntityState::dequantize(state->qz) - observer.z;
+        float dist_sq = dx * dx + dz * dz;
+
+        float limit = radius;
+        if (previous) {
+            auto it = std::lower_bound(previous->begin(), previous->end(), id, lessById);
+            if (it != previous->end() && it->id == id) {
+                limit = exit_radius;
+            }
+        }
+
+        if (id == self_id || dist_sq <= limit * limit) {
+            relevant_.push_back(*state);
+            has_self |= (id == self_id);
+        }
+    }
+
+    // O próprio jogador é sempre relevante
+    if (!has_self) {
+        if (const EntityState* self = findEntity(self_id)) {
+            relevant_.push_back(*self);
+        }
+    }
+
+    std::sort(relevant_.begin(), relevant_.end(),
+              [](const EntityState& a, const EntityState& b) { return a.id < b.id; });
+}
+
+void ReplicationManager::applyBudget(ClientState& client, const Vector3& observer,
+                                     const std::vector<EntityState>* baseline, uint32_t self_id,
+                                     size_t byte_budget) {
+    static const std::vector<EntityState> empty;
+    const std::vector<EntityState>& base = baseline ? *baseline : empty;
+
+    float radius = client.view_radius > 0.0f ? client.view_radius : default_view_radius_;
+    float radius_sq = radius * radius;
+
+    // Remoções sempre entram: são baratas e liberam o cliente
+    size_t fixed_cost = SnapshotEncoder::kHeaderSize;
+    size_t total_cost = 0;
+    candidates_.clear();
+    updates_.resize(relevant_.size());
+    {
+        size_t i = 0;
+        size_t u = 0;
+        const std::vector<EntityUpdate>& last_update = client.last_update;
+        for (size_t j = 0; j < relevant_.size(); ++j) {
+            const EntityState& cur = relevant_[j];
+            while (i < base.size() && base[i].id < cur.id) {
+                fixed_cost += varUIntSize(base[i].id);
+                ++i;
+            }
+            while (u < last_update.size() && last_update[u].id < cur.id) {
+                ++u;
+            }
+            uint32_t updated = (u < last_update.size() && last_update[u].id == cur.id) ? last_update[u].sequence : 0;
+            updates_[j] = {cur.id, updated};
+
+            const EntityState* prev = (i < base.size() && base[i].id == cur.id) ? &base[i++] : nullptr;
+            size_t cost = SnapshotEncoder::entitySize(prev, cur, prev ? 0 : lookupName(cur.id).size());
+            if (cost == 0) {
+                continue;
+            }
+            total_cost += cost;
+
+            float priority;
+            if (cur.id == self_id) {
+                priority = std::numeric_limits<float>::max();
+            } else {
+                uint32_t staleness = updated != 0 ? sequence_ - updated : kHistorySize;
+
+                float dx = EntityState::dequantize(cur.qx) - observer.x;
+                float dz = EntityState::dequantize(cur.qz) - observer.z;
+                priority = static_cast<float>(staleness) / (1.0f + (dx * dx + dz * dz) / radius_sq);
+            }
+            candidates_.push_back({j, cost, priority});
+        }
+        for (; i < base.size(); ++i) {
+            fixed_cost += varUIntSize(base[i].id);
+        }
+    }
+
+    size_t remaining = byte_budget > fixed_cost ? byte_budget - fixed_cost : 0;
+    if (total_cost <= remaining) {
+        for (const Candidate& c : candidates_) {
+            updates_[c.index].sequence = sequence_;
+        }
+        storeUpdates(client);
+        return;
+    }
+
+    std::sort(candidates_.begin(), candidates_.end(),
+              [](const Candidate& a, const Candidate& b) { return a.priority > b.priority; });
+
+    bool dropped_spawn = false;
+    for (const Candidate& c : candidates_) {
+        EntityState& cur = relevant_[c.index];
+        if (c.cost <= remaining) {
+            remaining -= c.cost;
+            updates_[c.index].sequence = sequence_;
+            continue;
+        }
+
+        // Adiada: o cliente continua com o que a baseline tem
+        auto it = std::lower_bound(base.begin(), base.end(), cur.id, lessById);
+        if (it != base.end() && it->id == cur.id) {
+            cur = *it;
+        } else {
+            cur.id = 0;
+            dropped_spawn = true;
+        }
+    }
+    storeUpdates(client);
+
+    if (dropped_spawn) {
+        relevant_.erase(std::remove_if(relevant_.begin(), relevant_.end(),
+                                       [](const EntityState& s) { return s.id == 0; }),
+                        relevant_.end());
+    }
+}
+
+void ReplicationManager::storeUpdates(ClientState& client) {
+    updates_.erase(std::remove_if(updates_.begin(), updates_.end(),
+                                  [](const EntityUpdate& u) { return u.sequence == 0; }),
+                   updates_.end());
+    client.last_update.swap(updates_);
+}
+
+bool ReplicationManager::buildSnapshotFor(uint32_t peer_id, const Vector3& observer,
+                                          SpatialGrid& grid, BinaryWriter& out,
+                                          size_t byte_budget) {
+    ClientState& client = clients_[peer_id];
+    const std::vector<EntityState>* baseline = findBaseline(client);
+
+    computeRelevantSet(client, observer, grid, peer_id);
+    if (byte_budget > 0) {
+        applyBudget(client, observer, baseline, peer_id, byte_budget);
+    }
+
+    static const std::vector<EntityState> empty;
+    uint32_t baseline_sequence = baseline ? client.acked_sequence : 0;
+
+    size_t changes = SnapshotEncoder::encodeDelta(
+        out, sequence_, baseline_sequence, baseline ? *baseline : empty, relevant_,
+        [this](uint32_t id) { return lookupName(id); }, &sent_);
+
+    // Nada mudou desde a baseline confirmada: não há o que enviar
+    if (baseline && changes == 0) {
+        return false;
+    }
+
+    SentSnapshot& slot = client.history[sequence_ % kHistorySize];
+    slot.sequence = sequence_;
+    // O que o cliente terá de fato: se o delta foi truncado, não é relevant_
+    slot.entities.swap(sent_);
+    client.last_sent_sequence = sequence_;
+    return true;
+}
+
+void ReplicationManager::acknowledge(uint32_t peer_id, uint32_t sequence) {
+    auto it = clients_.find(peer_id);
+    if (it == clients_.end()) {
+        return;
+    }
+    // Ignora ACKs fora de ordem ou de snapshots que nunca foram enviados
+    if (sequence > it->second.acked_sequence && sequence <= sequence_) {
+        it->second.acked_sequence = sequence;
+    }
+}
+
+void ReplicationManager::removeClient(uint32_t peer_id) {
+    clients_.erase(peer_id);
+
+    // O handle não volta (nova geração a cada reconexão)
+    for (auto& entry : clients_) {
+        auto& updates = entry.second.last_update;
+        auto it = std::lower_bound(updates.begin(), updates.end(), peer_id,
+                                   [](const EntityUpdate& u, uint32_t id) { return u.id < id; });
+        if (it != updates.end() && it->id == peer_id) {
+            updates.erase(it);
+        }
+    }
+}
+
+void ReplicationManager::setViewRadius(uint32_t peer_id, float radius) {
+    clients_[peer_id].view_radius = radius;
+}
@@ -0,0 +1,118 @@
+// include/server/ReplicationManager.h
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <string_view>
+#include <vector>
+#include "server/Snapshot.h"
+#include "server/PeerTable.h"
+
+class Player;
+class SpatialGrid;
+struct NeighborLists;
+
+// Mantém o histórico de snapshots enviados a cada cliente e gera o
+// payload WORLD_STATE como delta contra o último snapshot confirmado.
+// Cada cliente só recebe as entidades dentro do seu raio de visão.
+class ReplicationManager {
+public:
+    explicit ReplicationManager(float default_view_radius);
+
+    // Captura o estado atual do mundo (chamar uma vez por tick de replicação).
+    // Os Player* capturados só são usados até o próximo captureWorld, com
+    // o mutex de jogadores do Server ainda travado.
+    void captureWorld(const PeerTable<std::shared_ptr<Player>>& players);
+
+    // Escreve o payload WORLD_STATE para um cliente observando a partir de
+    // 'observer' no fim de 'out' (em geral o buffer de um OutboundPacket).
+    // Retorna false se não há nada novo a enviar (delta vazio sobre uma
+    // baseline confirmada).
+    // Com byte_budget > 0, entidades de menor prioridade (mais distantes
+    // e atualizadas há menos tempo) são adiadas para caber no orçamento.
+    bool buildSnapshotFor(uint32_t peer_id, const Vector3& observer,
+                          SpatialGrid& grid, BinaryWriter& out,
+                          size_t byte_budget = 0);
+
+    // SNAPSHOT_ACK recebido do cliente
+    void acknowledge(uint32_t peer_id, uint32_t sequence);
+
+    void removeClient(uint32_t peer_id);
+
+    // Raio de visão por cliente (0 = usa o default da config)
+    void setViewRadius(uint32_t peer_id, float radius);
+
+    // Listas de vizinhos do tick (World::computeNeighbors). Clientes cujo
+    // raio de saída cabe em neighbors->radius as usam em vez do grid.
+    void setNeighbors(const NeighborLists* neighbors) { neighbors_ = neighbors; }
+    // Raio que cobre o raio de saída do default
+    float getNeighborRadius() const { return default_view_radius_ * kExitHysteresis; }
+
+    uint32_t getCurrentSequence() const { return sequence_; }
+
+private:
+    // Snapshots além desta janela não podem mais servir de baseline
+    static constexpr size_t kHistorySize = 32;
+
+    // Entidades já visíveis só saem do conjunto além de raio * este fator,
+    // evitando spawn/despawn repetido na borda
+    static constexpr float kExitHysteresis = 1.1f;
+
+    struct SentSnapshot {
+        uint32_t sequence = 0;
+        std::vector<EntityState> entities;
+    };
+
+    // Sequence em que a entidade foi enviada com mudanças pela última vez
+    // (0 = nunca)
+    struct EntityUpdate {
+        uint32_t id;
+        uint32_t sequence;
+    };
+
+    struct ClientState {
+        uint32_t acked_sequence = 0;
+        uint32_t last_sent_sequence = 0;
+        float view_radius = 0.0f;
+        std::array<SentSnapshot, kHistorySize> history;
+
+        // Define a prioridade de quem ficou para trás. Ordenado por id e
+        // refeito a cada applyBudget só com as entidades relevantes, então
+        // não cresce com quem saiu da visão ou do servidor.
+        std::vector<EntityUpdate> last_update;
+    };
+
+    struct Candidate {
+        size_t index;       // em relevant_
+        size_t cost;        // bytes no snapshot
+        float priority;
+    };
+
+    const std::vector<EntityState>* findBaseline(const ClientState& client) const;
+    const EntityState* findEntity(uint32_t id) const;
+    std::string_view lookupName(uint32_t id) const;
+
+    void computeRelevantSet(const ClientState& client, const Vector3& observer,
+                            SpatialGrid& grid, uint32_t self_id);
+
+    // Substitui as entidades adiadas pelo estado da baseline (ou as tira
+    // do conjunto, se ainda não foram criadas no cliente)
+    void applyBudget(ClientState& client, const Vector3& observer,
+                     const std::vector<EntityState>* baseline, uint32_t self_id, size_t byte_budget);
+    // Troca last_update do cliente por updates_ (sem as nunca enviadas)
+    void storeUpdates(ClientState& client);
+
+    uint32_t sequence_ = 0;
+    float default_view_radius_;
+    std::vector<EntityState> world_;             // ordenado por id
+    std::vector<const Player*> world_players_;   // paralelo a world_
+    std::unordered_map<uint32_t, ClientState> clients_;
+    std::vector<EntityState> relevant_;           // scratch por cliente
+    std::vector<EntityState> sent_;               // scratch: estado aplicado pelo delta
+    std::vector<uint32_t> nearby_;                // scratch da query no grid
+    const NeighborLists* neighbors_ = nullptr;
+    std::vector<Candidate> candidates_;           // scratch de applyBudget
+    std::vector<EntityUpdate> updates_;           // scratch de applyBudget, paralelo a relevant_
+};
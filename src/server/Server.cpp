@@ -2,6 +2,9 @@
 #include "server/Server.h"
 #include "server/NetworkManager.h"
 #include "server/AntiCheat.h"
+#include "server/ReplicationManager.h"
+#include "server/BandwidthScheduler.h"
+#include "server/TickScheduler.h"
 #include "database/DatabaseManager.h"
 #include "scripting/LuaManager.h"
 #include "server/World.h"
@@ -9,7 +12,10 @@
 #include "utils/Logger.h"
 #include "utils/Config.h"
 #include "utils/PerformanceMonitor.h"
+#include "utils/BinaryStream.h"
+#include <magic_enum/magic_enum.hpp>
 #include <chrono>
+#include <cstring>
 #include "Server.h"
 
 Server::Server(uint16_t port, size_t max_clients)
@@ -38,13 +44,75 @@ bool Server::initialize()
     }
 
     // Cria módulos
-    network_manager_ = std::make_unique<NetworkManager>(port_, max_clients_);
+    NetworkOptions net_options;
+    net_options.io_thread = Config::getInstance().isNetworkIOThreadEnabled();
+    net_options.queue_capacity = Config::getInstance().getNetworkQueueCapacity();
+    net_options.host_count = Config::getInstance().getNetworkHostCount();
+    net_options.reuse_port = Config::getInstance().isNetworkReusePortEnabled();
+    net_options.batching = Config::getInstance().isNetworkBatchingEnabled();
+    net_options.batch_size = Config::getInstance().getNetworkBatchSize();
+    net_options.packet_pool_size = Config::getInstance().getNetworkPacketPoolSize();
+
+    for (const auto &[type_name, class_name] : Config::getInstance().getNetworkChannels())
+    {
+        auto type = magic_enum::enum_cast<PacketType>(type_name);
+        auto cls = magic_enum::enum_cast<ChannelClass>(class_name);
+        if (!type || !cls)
+        {
+            Logger::warning("Invalid channel mapping: " + type_name + " -> " + class_name);
+            continue;
+        }
+        net_options.channels.set(*type, *cls);
+    }
+
+    for (const auto &name : Config::getInstance().getNetworkCompression())
+    {
+        auto mode = magic_enum::enum_cast<CompressionMode>(name);
+        if (!mode)
+        {
+            Logger::warning("Unknown compression mode: " + name + ", using NONE");
+        }
+        net_options.compression.push_back(mode.value_or(CompressionMode::NONE));
+    }
+    net_options.compression_level = Config::getInstance().getNetworkCompressionLevel();
+    net_options.compression_dictionary = Config::getInstance().getNetworkCompressionDictionary();
+    net_options.capture_file = capture_file_.empty() ? Config::getInstance().getNetworkCaptureFile() : capture_file_;
+    net_options.replay_file = replay_file_;
+    if (!net_options.replay_file.empty())
+    {
+        net_options.capture_file.clear();
+    }
+
+    // O loop espera pelo próximo tick ou por tráfego (sockets da ENet ou,
+    // com threads de I/O, um aviso delas)
+    scheduler_ = std::make_unique<TickScheduler>(static_cast<float>(Config::getInstance().getTickRate()),
+                                                 Config::getInstance().getTickSpinMicros());
+    if (!scheduler_->initialize())
+    {
+        Logger::error("Failed to initialize TickScheduler");
+        return false;
+    }
+
+    TickScheduler *scheduler = scheduler_.get();
+    network_manager_ = std::make_unique<NetworkManager>(port_, max_clients_, net_options);
+    network_manager_->setInboundNotifier([scheduler]() { scheduler->notify(); });
     if (!network_manager_->initialize())
     {
         Logger::error("Failed to initialize NetworkManager");
         return false;
     }
 
+    for (ENetSocket socket : network_manager_->getPollSockets())
+    {
+        if (!scheduler_->watchSocket(socket))
+        {
+            return false;
+        }
+    }
+
+    // Um slot por peer possível: buscas por handle viram indexação
+    players_ = PeerTable<std::shared_ptr<Player>>(network_manager_->getPeerSlotCount());
+
     database_manager_ = std::make_unique<DatabaseManager>();
     std::string db_conn = Config::getInstance().getDatabaseConnectionString();
     if (!database_manager_->connect(db_conn))
@@ -60,8 +128,24 @@ bool Server::initialize()
         return false;
     }
 
-    world_ = std::make_unique<World>();
+    std::string backend_name = Config::getInstance().getSpatialBackend();
+    auto spatial_backend = magic_enum::enum_cast<SpatialBackend>(backend_name);
+    if (!spatial_backend)
+    {
+        Logger::warning("Unknown spatial backend: " + backend_name + ", using HASH");
+    }
+    world_ = std::make_unique<World>(spatial_backend.value_or(SpatialBackend::HASH),
+                                     Config::getInstance().getSpatialGridCellSize(),
+                                     Config::getInstance().getWorldSize(),
+                                     Config::getInstance().getNeighborThreads());
     anti_cheat_ = std::make_unique<AntiCheat>();
+    replication_ = std::make_unique<ReplicationManager>(Config::getInstance().getViewRadius());
+
+    // Até 250 ms de taxa acumulada por peer
+    if (size_t peer_bandwidth = Config::getInstance().getPeerBandwidth())
+    {
+        bandwidth_ = std::make_unique<BandwidthScheduler>(peer_bandwidth, 0.25f);
+    }
 
     Logger::info("Server initialized successfully");
     Logger::info("Tick rate: " + std::to_string(Config::getInstance().getTickRate()) + " Hz");
@@ -73,23 +157,30 @@ void Server::run()
 {
     running_ = true;
 
-    auto last_time = std::chrono::high_resolution_clock::now();
-    auto last_report_time = last_time;
+    if (network_manager_->isReplaying())
+    {
+        runReplay();
+        return;
+    }
 
-    float target_fps = static_cast<float>(Config::getInstance().getTickRate());
-    const auto frame_duration = std::chrono::microseconds(
-        static_cast<long long>(1000000.0f / target_fps));
+    auto last_report_time = std::chrono::steady_clock::now();
 
     Logger::info("Server main loop started");
+    scheduler_->start();
 
     while (running_)
     {
-        PerformanceMonitor::getInstance().startFrame();
+        // Tráfego antes do deadline é processado na hora; o mundo só
+        // avança quando o tick vence
+        bool tick_due = scheduler_->wait();
+        if (!tick_due)
+        {
+            processEvents();
+            continue;
+        }
 
-        auto current_time = std::chrono::high_resolution_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
-            current_time - last_time);
-        float delta_time = elapsed.count() / 1000000.0f;
+        float delta_time = scheduler_->beginTick();
+        PerformanceMonitor::getInstance().startFrame();
 
         processEvents();
         update(delta_time);
@@ -98,30 +189,55 @@ void Server::run()
         PerformanceMonitor::getInstance().setConnectedPlayers(players_.size());
 
         // Performance report a cada 60 segundos
+        auto current_time = std::chrono::steady_clock::now();
         auto report_elapsed = std::chrono::duration_cast<std::chrono::seconds>(
             current_time - last_report_time);
         if (report_elapsed.count() >= 60)
         {
             PerformanceMonitor::getInstance().printReport();
+            network_manager_->logTelemetryReport();
             last_report_time = current_time;
         }
+    }
 
-        // Sleep para manter FPS consistente
-        auto frame_time = std::chrono::high_resolution_clock::now() - current_time;
-        if (frame_time < frame_duration)
-        {
-            std::this_thread::sleep_for(frame_duration - frame_time);
-        }
+    Logger::info("Server main loop ended");
+}
 
-        last_time = current_time;
+// Alimenta processEvents com a captura, um tick por iteração, sem
+// dormir e com delta fixo, para que duas execuções vejam a mesma sequência
+void Server::runReplay()
+{
+    const float delta_time = 1.0f / static_cast<float>(Config::getInstance().getTickRate());
+    uint64_t ticks = 0;
+
+    Logger::info("Replaying packet capture at full speed");
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    while (running_ && !network_manager_->isReplayFinished())
+    {
+        PerformanceMonitor::getInstance().startFrame();
+
+        processEvents();
+        update(delta_time);
+
+        PerformanceMonitor::getInstance().endFrame();
+        PerformanceMonitor::getInstance().setConnectedPlayers(players_.size());
+        ++ticks;
     }
 
-    Logger::info("Server main loop ended");
+    auto elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time);
+    Logger::info("Replay finished: " + std::to_string(ticks) + " ticks in " +
+                 std::to_string(elapsed.count()) + " s (" +
+                 std::to_string(elapsed.count() > 0.0 ? ticks / elapsed.count() : 0.0) + " ticks/s)");
+    PerformanceMonitor::getInstance().printReport();
+    network_manager_->logTelemetryReport();
 }
 
 void Server::processEvents()
 {
-    auto packets = network_manager_->pollEvents(1);
+    // Os pacotes apontam direto para os buffers da ENet até releasePackets().
+    // A espera fica com o TickScheduler, então aqui só drena.
+    auto &packets = network_manager_->pollEvents(0);
 
     for (const auto &packet : packets)
     {
@@ -136,36 +252,41 @@ void Server::processEvents()
         case PacketType::DISCONNECT:
         {
             Logger::info("Client disconnected: " + std::to_string(packet.peer_id));
+            replication_->removeClient(packet.peer_id);
+            if (bandwidth_)
+            {
+                bandwidth_->removePeer(packet.peer_id);
+            }
             std::lock_guard<std::mutex> lock(players_mutex_);
 
-            auto it = players_.find(packet.peer_id);
-            if (it != players_.end())
+            if (players_.erase(packet.peer_id))
             {
                 world_->removePlayer(packet.peer_id);
-                players_.erase(it);
             }
             break;
         }
 
         case PacketType::AUTH_REQUEST:
-            lua_manager_->callFunction("handle_auth_request", packet.peer_id, packet.data);
+            lua_manager_->callFunction("handle_auth_request", packet.peer_id, &packet.data);
             break;
 
         case PacketType::PLAYER_MOVE:
         {
-            if (players_.count(packet.peer_id))
+            if (auto *found = players_.find(packet.peer_id))
             {
-                auto player = players_[packet.peer_id];
+                auto player = *found;
 
-                // Garante que temos bytes suficientes
-                if (packet.data.size() < sizeof(float) * 3)
+                // Garante que temos bytes suficientes (após o byte de tipo)
+                auto payload = packet.data.payload();
+                if (payload.size() < sizeof(float) * 3)
                 {
                     Logger::error("Pacote PLAYER_MOVE inválido (tamanho insuficiente)");
                     break;
                 }
 
                 // Faz parsing binário direto
-                const float *coords = reinterpret_cast<const float *>(packet.data.data());
+                float coords[3];
+                std::memcpy(coords, payload.data(), sizeof(coords));
                 Vector3 new_pos{coords[0], coords[1], coords[2]};
 
                 Vector3 old_pos = player->getPosition();
@@ -191,7 +312,7 @@ void Server::processEvents()
                 player->setPosition(new_pos);
 
                 // Passa pacote bruto pro Lua
-                lua_manager_->callFunction("handle_player_move", packet.peer_id, packet.data);
+                lua_manager_->callFunction("handle_player_move", packet.peer_id, &packet.data);
             }
             break;
         }
@@ -199,26 +320,70 @@ void Server::processEvents()
         case PacketType::PLAYER_ACTION:
             if (anti_cheat_->validatePlayerAction(packet.peer_id, "action"))
             {
-                lua_manager_->callFunction("handle_player_action", packet.peer_id, packet);
+                lua_manager_->callFunction("handle_player_action", packet.peer_id, &packet);
             }
             break;
 
         case PacketType::CHAT_MESSAGE:
-            lua_manager_->callFunction("handle_chat_message", packet.peer_id, packet);
+            lua_manager_->callFunction("handle_chat_message", packet.peer_id, &packet);
             break;
 
+        case PacketType::SNAPSHOT_ACK:
+        {
+            // [tipo][u32 sequence]
+            auto payload = packet.data.payload();
+            if (payload.size() < sizeof(uint32_t))
+            {
+                break;
+            }
+            BinaryReader reader(payload.data(), payload.size());
+            replication_->acknowledge(packet.peer_id, reader.readU32());
+            break;
+        }
+
+        case PacketType::SERVER_STATS:
+        {
+            // Só responde com network.stats_requests habilitado (benchmarks)
+            if (!Config::getInstance().isStatsRequestEnabled())
+            {
+                break;
+            }
+
+            // [tipo][f32 avg_frame_ms][f32 max_frame_ms][u64 frames][u32 players]
+            //       [u64 packets_sent][u64 packets_received]
+            PerformanceMetrics metrics = PerformanceMonitor::getInstance().getMetrics();
+            OutboundPacket reply = network_manager_->createPacket(PacketType::SERVER_STATS);
+            BinaryWriter writer = reply.writer();
+            writer.writeFloat(static_cast<float>(metrics.avg_frame_time_ms));
+            writer.writeFloat(static_cast<float>(metrics.max_frame_time_ms));
+            writer.writeU64(metrics.total_frames);
+            writer.writeU32(static_cast<uint32_t>(metrics.connected_players));
+            writer.writeU64(metrics.total_packets_sent);
+            writer.writeU64(metrics.total_packets_received);
+            network_manager_->sendPacket(packet.peer_id, std::move(reply));
+            break;
+        }
+
         case PacketType::NETWORK_COMMAND_REMOTE_CALL:
         {
             network_manager_->getRPCHandler().processGodotPacket(packet.peer_id, packet.data);
             break;
         }
 
+        case PacketType::NETWORK_COMMAND_REMOTE_CALL_BATCH:
+        {
+            network_manager_->getRPCHandler().processGodotBatch(packet.peer_id, packet.data);
+            break;
+        }
+
         default:
             Logger::warning("Unknown packet type received: " +
                             std::to_string(static_cast<int>(packet.type)));
             break;
         }
     }
+
+    network_manager_->releasePackets();
 }
 
 void Server::update(float delta_time)
@@ -235,23 +400,7 @@ void Server::update(float delta_time)
 
     if (accumulator >= 0.05f)
     {
-        nlohmann::json world_state;
-        world_state["players"] = nlohmann::json::array();
-
-        std::lock_guard<std::mutex> lock(players_mutex_);
-        for (const auto &[id, player] : players_)
-        {
-            world_state["players"].push_back(player->toJson());
-        }
-
-        std::string json_str = world_state.dump();
-        std::vector<uint8_t> data(json_str.begin(), json_str.end());
-
-        if (network_manager_->broadcastPacket(PacketType::WORLD_STATE, data, 0))
-        {
-            PerformanceMonitor::getInstance().recordPacketSent();
-        }
-
+        replicateWorldState(accumulator);
         accumulator = 0.0f;
     }
 
@@ -264,6 +413,58 @@ void Server::update(float delta_time)
         savePlayerStates();
         db_accumulator = 0.0f;
     }
+
+    // Envia as mensagens acumuladas no tick, um pacote por peer
+    network_manager_->flush();
+    network_manager_->endTick();
+}
+
+void Server::replicateWorldState(float elapsed)
+{
+    std::lock_guard<std::mutex> lock(players_mutex_);
+    replication_->captureWorld(players_);
+
+    // Vizinhos de todos de uma vez (no pool do World) em vez de uma query
+    // no grid por cliente
+    replication_->setNeighbors(&world_->computeNeighbors(replication_->getNeighborRadius()));
+
+    // Cada cliente recebe, como delta binário contra o último snapshot que
+    // confirmou, apenas as entidades dentro do seu raio de visão
+    SpatialGrid &grid = *world_->getSpatialGrid();
+    for (const auto &[peer_id, player] : players_)
+    {
+        // Orçamento do peer conforme RTT, throttle e fila de saída da ENet
+        // (ou um enlace presumido até a primeira amostra). Sem orçamento
+        // neste tick o peer fica para o próximo.
+        size_t budget = 0;
+        if (bandwidth_)
+        {
+            PeerLinkStats link;
+            if (!network_manager_->getPeerLinkStats(peer_id, link))
+            {
+                link = BandwidthScheduler::unknownLink();
+            }
+            budget = bandwidth_->budgetFor(peer_id, link, elapsed);
+            if (budget == 0)
+            {
+                continue;
+            }
+        }
+
+        // O snapshot é serializado direto no buffer que vai para a ENet
+        OutboundPacket packet = network_manager_->createPacket(PacketType::WORLD_STATE);
+        BinaryWriter writer = packet.writer();
+        if (!replication_->buildSnapshotFor(peer_id, player->getPosition(), grid, writer, budget))
+        {
+            continue;
+        }
+
+        size_t packet_size = packet.size();
+        if (network_manager_->sendPacket(peer_id, std::move(packet)) && bandwidth_)
+        {
+            bandwidth_->consume(peer_id, packet_size);
+        }
+    }
 }
 
 void Server::savePlayerStates()
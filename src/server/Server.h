@@ -7,6 +7,9 @@
 #include <atomic>
 #include <thread>
 #include <mutex>
+#include <vector>
+#include <string>
+#include "server/PeerTable.h"
 
 class NetworkManager;
 class DatabaseManager;
@@ -14,6 +17,9 @@ class LuaManager;
 class World;
 class Player;
 class AntiCheat;
+class ReplicationManager;
+class BandwidthScheduler;
+class TickScheduler;
 
 class Server {
 public:
@@ -24,6 +30,12 @@ public:
     void run();
     void shutdown();
 
+    // Chamar antes de initialize(). A captura também pode vir de
+    // network.capture_file; o replay roda sem sockets, em velocidade
+    // máxima e com delta fixo, e termina no fim da captura.
+    void setCaptureFile(const std::string& path) { capture_file_ = path; }
+    void setReplayFile(const std::string& path) { replay_file_ = path; }
+
     // Getters
     NetworkManager* getNetworkManager() const { return network_manager_.get(); }
     DatabaseManager* getDatabaseManager() const { return database_manager_.get(); }
@@ -33,19 +45,27 @@ public:
 private:
     void processEvents();
     void update(float delta_time);
+    void runReplay();
+    void replicateWorldState(float elapsed);
 
     void savePlayerStates();
 
     uint16_t port_;
     size_t max_clients_;
     std::atomic<bool> running_;
+    std::string capture_file_;
+    std::string replay_file_;
     
     std::unique_ptr<NetworkManager> network_manager_;
     std::unique_ptr<DatabaseManager> database_manager_;
     std::unique_ptr<LuaManager> lua_manager_;
     std::unique_ptr<World> world_;
     std::unique_ptr<AntiCheat> anti_cheat_;
+    std::unique_ptr<ReplicationManager> replication_;
+    std::unique_ptr<BandwidthScheduler> bandwidth_;   // nullptr = sem limite
+    std::unique_ptr<TickScheduler> scheduler_;
     
-    std::unordered_map<uint32_t, std::shared_ptr<Player>> players_;
+    // Indexado pelo handle do peer (slot + geração)
+    PeerTable<std::shared_ptr<Player>> players_;
     std::mutex players_mutex_;
 };
\ No newline at end of file
@@ -0,0 +1,180 @@
+// src/server/Snapshot.cpp
+#include "server/Snapshot.h"
+#include "utils/BinaryStream.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+int32_t EntityState::quantize(float v) {
+    // Posições vêm do cliente: NaN/inf viram 0 e o resto é limitado a
+    // ±2^30, que cabe em long mesmo onde ele tem 32 bits
+    if (!std::isfinite(v)) {
+        return 0;
+    }
+    constexpr double kLimit = 1 << 30;
+    double scaled = std::clamp(static_cast<double>(v) * kPositionScale, -kLimit, kLimit);
+    return static_cast<int32_t>(std::lround(scaled));
+}
+
+float EntityState::dequantize(int32_t q) {
+    return static_cast<float>(q) / kPositionScale;
+}
+
+// a - b em aritmética modular: posições distantes não estouram int32 e o
+// cliente reconstrói somando da mesma forma
+static int32_t positionDelta(int32_t a, int32_t b) {
+    return static_cast<int32_t>(static_cast<uint32_t>(a) - static_cast<uint32_t>(b));
+}
+
+static void writeEntity(BinaryWriter& out, const EntityState* base, const EntityState& cur,
+                        uint8_t mask, const SnapshotEncoder::NameLookup& lookup_name) {
+    static const EntityState zero{};
+    const EntityState& ref = base ? *base : zero;
+
+    out.writeVarUInt(cur.id);
+    out.writeU8(mask);
+
+    if (mask & FIELD_SPAWN) {
+        out.writeString(lookup_name ? lookup_name(cur.id) : std::string_view{});
+    }
+    if (mask & FIELD_POSITION) {
+        out.writeVarInt(positionDelta(cur.qx, ref.qx));
+        out.writeVarInt(positionDelta(cur.qy, ref.qy));
+        out.writeVarInt(positionDelta(cur.qz, ref.qz));
+    }
+    if (mask & FIELD_HEALTH) {
+        out.writeVarInt(cur.health - ref.health);
+    }
+    if (mask & FIELD_LEVEL) {
+        out.writeVarInt(cur.level - ref.level);
+    }
+}
+
+static uint8_t diffMask(const EntityState& a, const EntityState& b) {
+    uint8_t mask = 0;
+    if (a.qx != b.qx || a.qy != b.qy || a.qz != b.qz) mask |= FIELD_POSITION;
+    if (a.health != b.health) mask |= FIELD_HEALTH;
+    if (a.level != b.level) mask |= FIELD_LEVEL;
+    return mask;
+}
+
+size_t SnapshotEncoder::entitySize(const EntityState* base, const EntityState& cur, size_t name_length) {
+    static const EntityState zero{};
+    const EntityState& ref = base ? *base : zero;
+
+    uint8_t mask = base ? diffMask(*base, cur) : FIELD_SPAWN | FIELD_POSITION | FIELD_HEALTH | FIELD_LEVEL;
+    if (mask == 0) {
+        return 0;
+    }
+
+    size_t size = varUIntSize(cur.id) + 1;
+    if (mask & FIELD_SPAWN) {
+        size += varUIntSize(name_length) + name_length;
+    }
+    if (mask & FIELD_POSITION) {
+        size += varUIntSize(zigzagEncode(positionDelta(cur.qx, ref.qx)));
+        size += varUIntSize(zigzagEncode(positionDelta(cur.qy, ref.qy)));
+        size += varUIntSize(zigzagEncode(positionDelta(cur.qz, ref.qz)));
+    }
+    if (mask & FIELD_HEALTH) {
+        size += varUIntSize(zigzagEncode(cur.health - ref.health));
+    }
+    if (mask & FIELD_LEVEL) {
+        size += varUIntSize(zigzagEncode(cur.level - ref.level));
+    }
+    return size;
+}
+
+size_t SnapshotEncoder::encodeDelta(BinaryWriter& out,
+                                    uint32_t sequence,
+                                    uint32_t baseline_sequence,
+                                    const std::vector<EntityState>& baseline,
+                                    const std::vector<EntityState>& current,
+                                    const NameLookup& lookup_name,
+                                    std::vector<EntityState>* applied) {
+    constexpr size_t kMaxCount = std::numeric_limits<uint16_t>::max();
+
+    out.writeU32(sequence);
+    out.writeU32(baseline_sequence);
+
+    // Remoções: ids da baseline ausentes no snapshot atual
+    size_t removed_offset = out.size();
+    out.writeU16(0);
+    size_t removed = 0;
+    size_t removed_end = 0;   // ids da baseline além daqui não foram removidos
+    {
+        size_t i = 0, j = 0;
+        while (i < baseline.size() && removed < kMaxCount) {
+            if (j >= current.size() || baseline[i].id < current[j].id) {
+                out.writeVarUInt(baseline[i].id);
+                ++removed;
+                ++i;
+            } else if (baseline[i].id == current[j].id) {
+                ++i;
+                ++j;
+            } else {
+                ++j;
+            }
+        }
+        removed_end = i;
+    }
+    out.patchU16(removed_offset, static_cast<uint16_t>(removed));
+
+    // Spawns e alterações
+    size_t count_offset = out.size();
+    out.writeU16(0);
+    size_t written = 0;
+    size_t current_end = 0;   // entidades de 'current' além daqui não foram escritas
+    {
+        size_t i = 0;
+        size_t j = 0;
+        for (; j < current.size() && written < kMaxCount; ++j) {
+            const EntityState& cur = current[j];
+            while (i < baseline.size() && baseline[i].id < cur.id) ++i;
+
+            if (i < baseline.size() && baseline[i].id == cur.id) {
+                uint8_t mask = diffMask(baseline[i], cur);
+                if (mask != 0) {
+                    writeEntity(out, &baseline[i], cur, mask, lookup_name);
+                    ++written;
+                }
+            } else {
+                writeEntity(out, nullptr, cur,
+                            FIELD_SPAWN | FIELD_POSITION | FIELD_HEALTH | FIELD_LEVEL, lookup_name);
+                ++written;
+            }
+        }
+        current_end = j;
+    }
+    out.patchU16(count_offset, static_cast<uint16_t>(written));
+
+    if (applied) {
+        if (removed_end == baseline.size() && current_end == current.size()) {
+            applied->assign(current.begin(), current.end());
+        } else {
+            // Truncado: o cliente mantém as remoções e entidades que não
+            // couberam como estavam na baseline
+            applied->clear();
+            size_t i = 0, j = 0;
+            while (i < baseline.size() || j < current.size()) {
+                if (j >= current.size() || (i < baseline.size() && baseline[i].id < current[j].id)) {
+                    if (i >= removed_end) {
+                        applied->push_back(baseline[i]);
+                    }
+                    ++i;
+                } else if (i >= baseline.size() || current[j].id < baseline[i].id) {
+                    if (j < current_end) {
+                        applied->push_back(current[j]);
+                    }
+                    ++j;
+                } else {
+                    applied->push_back(j < current_end ? current[j] : baseline[i]);
+                    ++i;
+                    ++j;
+                }
+            }
+        }
+    }
+
+    return removed + written;
+}
@@ -0,0 +1,77 @@
+// include/server/Snapshot.h
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <string_view>
+#include "utils/Structs.h"
+
+class BinaryWriter;
+
+// Estado replicado de uma entidade, já quantizado.
+// Posições usam ponto fixo com resolução de 1/kPositionScale unidades.
+struct EntityState {
+    static constexpr float kPositionScale = 64.0f;
+
+    uint32_t id = 0;
+    int32_t qx = 0, qy = 0, qz = 0;
+    int16_t health = 0;
+    int16_t level = 0;
+
+    static int32_t quantize(float v);
+    static float dequantize(int32_t q);
+
+    Vector3 getPosition() const { return Vector3{dequantize(qx), dequantize(qy), dequantize(qz)}; }
+};
+
+// Formato binário do payload WORLD_STATE (após o byte de tipo):
+//
+//   u32      sequence           número deste snapshot
+//   u32      baseline           snapshot usado como base do delta (0 = completo)
+//   u16      removed_count
+//   varuint  removed_id...      entidades que saíram desde a baseline
+//   u16      entity_count
+//   por entidade:
+//     varuint  id
+//     u8       field_mask       SnapshotField
+//     [string  username]        apenas se FIELD_SPAWN
+//     [varint  dx, dy, dz]      se FIELD_POSITION (delta zigzag vs baseline,
+//                               módulo 2^32)
+//     [varint  dhealth]         se FIELD_HEALTH
+//     [varint  dlevel]          se FIELD_LEVEL
+//
+// Entidades com FIELD_SPAWN são codificadas contra zero. O cliente
+// responde com SNAPSHOT_ACK (u32 sequence) para avançar a baseline.
+enum SnapshotField : uint8_t {
+    FIELD_POSITION = 1 << 0,
+    FIELD_HEALTH   = 1 << 1,
+    FIELD_LEVEL    = 1 << 2,
+    FIELD_SPAWN    = 1 << 7
+};
+
+class SnapshotEncoder {
+public:
+    using NameLookup = std::function<std::string_view(uint32_t id)>;
+
+    // Codifica 'current' como delta de 'baseline'. Ambos devem estar
+    // ordenados por id. Retorna o número de entidades escritas
+    // (spawns + alterações + remoções).
+    // Remoções e entidades param em 65535 cada; o resto fica para o próximo
+    // delta. Com 'applied', recebe o estado que o cliente terá após aplicar
+    // o que foi de fato escrito (igual a 'current' se nada foi cortado).
+    static size_t encodeDelta(BinaryWriter& out,
+                              uint32_t sequence,
+                              uint32_t baseline_sequence,
+                              const std::vector<EntityState>& baseline,
+                              const std::vector<EntityState>& current,
+                              const NameLookup& lookup_name,
+                              std::vector<EntityState>* applied = nullptr);
+
+    // Bytes que encodeDelta gasta com uma entidade (base = nullptr para
+    // spawn), sem escrever nada. 0 se não há mudança.
+    static size_t entitySize(const EntityState* base, const EntityState& cur, size_t name_length);
+
+    // Bytes fixos de cabeçalho (sequence, baseline e os dois contadores)
+    static constexpr size_t kHeaderSize = 4 + 4 + 2 + 2;
+};
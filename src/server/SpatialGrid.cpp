@@ -0,0 +1,931 @@
+// src/server/SpatialGrid.cpp
+#include "server/SpatialGrid.h"
+#include "utils/Logger.h"
+#include "utils/ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SPATIAL_GRID_SSE2 1
+#endif
+
+// AVX2 por função, escolhido em runtime: o build não assume AVX2
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SPATIAL_GRID_AVX2 1
+#endif
+
+// ========== Filtro de distância ==========
+
+// Escreve em out os ids com (x - cx)² + (z - cz)² <= radius_sq; out tem
+// espaço para count ids. Retorna quantos foram escritos.
+using RadiusFilter = size_t (*)(const uint32_t* ids, const float* xs, const float* zs, size_t count,
+                                float cx, float cz, float radius_sq, uint32_t* out);
+
+static size_t filterScalar(const uint32_t* ids, const float* xs, const float* zs, size_t count,
+                           float cx, float cz, float radius_sq, uint32_t* out) {
+    size_t written = 0;
+    for (size_t i = 0; i < count; ++i) {
+        float dx = xs[i] - cx;
+        float dz = zs[i] - cz;
+        // Sem desvio: escreve sempre e só avança se passou
+        out[written] = ids[i];
+        written += (dx * dx + dz * dz <= radius_sq) ? 1 : 0;
+    }
+    return written;
+}
+
+#ifdef SPATIAL_GRID_SSE2
+static size_t filterSse2(const uint32_t* ids, const float* xs, const float* zs, size_t count,
+                         float cx, float cz, float radius_sq, uint32_t* out) {
+    const __m128 center_x = _mm_set1_ps(cx);
+    const __m128 center_z = _mm_set1_ps(cz);
+    const __m128 limit = _mm_set1_ps(radius_sq);
+
+    size_t written = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + i), center_x);
+        __m128 dz = _mm_sub_ps(_mm_loadu_ps(zs + i), center_z);
+        __m128 dist_sq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dz, dz));
+        int mask = _mm_movemask_ps(_mm_cmple_ps(dist_sq, limit));
+        for (int lane = 0; lane < 4; ++lane) {
+            out[written] = ids[i + lane];
+            written += (mask >> lane) & 1;
+        }
+    }
+    return written + filterScalar(ids + i, xs + i, zs + i, count - i, cx, cz, radius_sq, out + written);
+}
+#endif
+
+#ifdef SPATIAL_GRID_AVX2
+__attribute__((target("avx2"))) static size_t filterAvx2(const uint32_t* ids, const float* xs,
+                                                         const float* zs, size_t count, float cx,
+                                                         float cz, float radius_sq, uint32_t* out) {
+    const __m256 center_x = _mm256_set1_ps(cx);
+    const __m256 center_z = _mm256_set1_ps(cz);
+    const __m256 limit = _mm256_set1_ps(radius_sq);
+
+    size_t written = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs + i), center_x);
+        __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(zs + i), center_z);
+        __m256 dist_sq = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dz, dz));
+        int mask = _mm256_movemask_ps(_mm256_cmp_ps(dist_sq, limit, _CMP_LE_OQ));
+        for (int lane = 0; lane < 8; ++lane) {
+            out[written] = ids[i + lane];
+            written += (mask >> lane) & 1;
+        }
+    }
+    return written + filterScalar(ids + i, xs + i, zs + i, count - i, cx, cz, radius_sq, out + written);
+}
+#endif
+
+static RadiusFilter selectRadiusFilter() {
+#ifdef SPATIAL_GRID_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        return filterAvx2;
+    }
+#endif
+#ifdef SPATIAL_GRID_SSE2
+    return filterSse2;
+#else
+    return filterScalar;
+#endif
+}
+
+static const RadiusFilter filterWithinRadius = selectRadiusFilter();
+
+// Acrescenta a out os ids de uma célula (ou faixa contígua) dentro do raio
+static void appendWithinRadius(const uint32_t* ids, const float* xs, const float* zs, size_t count,
+                               float cx, float cz, float radius_sq, std::vector<uint32_t>& out) {
+    if (count == 0) {
+        return;
+    }
+    size_t size = out.size();
+    out.resize(size + count);
+    out.resize(size + filterWithinRadius(ids, xs, zs, count, cx, cz, radius_sq, out.data() + size));
+}
+
+// ========== SpatialGrid ==========
+
+std::vector<uint32_t> SpatialGrid::queryRadius(float x, float z, float radius) {
+    std::vector<uint32_t> result;
+    queryRadiusInto(x, z, radius, result);
+    return result;
+}
+
+// ========== Vizinhos em lote ==========
+
+size_t NeighborLists::indexOf(uint32_t id) const {
+    uint32_t slot = peer_handle::slot(id);
+    if (slot >= index_by_slot.size()) {
+        return kNoIndex;
+    }
+    uint32_t index = index_by_slot[slot];
+    if (index == kNoIndex || ids[index] != id) {
+        return kNoIndex;
+    }
+    return index;
+}
+
+std::span<const uint32_t> NeighborLists::find(uint32_t id) const {
+    size_t index = indexOf(id);
+    return index == kNoIndex ? std::span<const uint32_t>() : at(index);
+}
+
+void NeighborLists::buildIndex() {
+    uint32_t max_slot = 0;
+    for (uint32_t id : ids) {
+        max_slot = std::max(max_slot, peer_handle::slot(id));
+    }
+    index_by_slot.assign(ids.empty() ? 0 : max_slot + 1, kNoIndex);
+    for (size_t i = 0; i < ids.size(); ++i) {
+        index_by_slot[peer_handle::slot(ids[i])] = static_cast<uint32_t>(i);
+    }
+}
+
+// Piso do número de células da passada em lote
+static constexpr size_t kMinNeighborCells = 1024;
+
+static void forRange(ThreadPool* pool, size_t count, const ThreadPool::RangeFunction& body, size_t grain) {
+    if (pool) {
+        pool->parallelFor(count, body, grain);
+    } else if (count > 0) {
+        body(0, count);
+    }
+}
+
+void SpatialGrid::computeNeighbors(float radius, NeighborLists& out, ThreadPool* pool) {
+    NeighborScratch& scratch = neighbor_scratch_;
+    std::vector<Position>& positions = scratch.positions;
+
+    positions.clear();
+    collectPositions(positions);
+
+    const size_t count = positions.size();
+    out.radius = radius;
+    out.ids.resize(count);
+    out.xs.resize(count);
+    out.zs.resize(count);
+    out.offsets.assign(count + 1, 0);
+    out.neighbors.clear();
+
+    // Caixa das posições finitas; as demais nunca passam no teste de distância
+    double min_x = std::numeric_limits<double>::infinity(), max_x = -min_x;
+    double min_z = min_x, max_z = max_x;
+    for (const Position& p : positions) {
+        if (std::isfinite(p.x) && std::isfinite(p.z)) {
+            min_x = std::min<double>(min_x, p.x);
+            max_x = std::max<double>(max_x, p.x);
+            min_z = std::min<double>(min_z, p.z);
+            max_z = std::max<double>(max_z, p.z);
+        }
+    }
+    if (count < 2 || !(radius >= 0.0f) || min_x > max_x) {
+        for (size_t i = 0; i < count; ++i) {
+            out.ids[i] = positions[i].id;
+            out.xs[i] = positions[i].x;
+            out.zs[i] = positions[i].z;
+        }
+        out.buildIndex();
+        return;
+    }
+
+    // Células de lado >= radius: os vizinhos ficam nas 8 em volta. Limitadas
+    // a ~4 por jogador para o scratch não crescer com o mundo vazio.
+    double cell_size = radius > 0.0f ? radius : 1.0;
+    const double max_cells = static_cast<double>(std::max(count * 4, kMinNeighborCells));
+    double columns_f, rows_f;
+    while (true) {
+        columns_f = std::floor((max_x - min_x) / cell_size) + 1.0;
+        rows_f = std::floor((max_z - min_z) / cell_size) + 1.0;
+        if (columns_f * rows_f <= max_cells) {
+            break;
+        }
+        cell_size *= 2.0;
+    }
+    const size_t columns = static_cast<size_t>(columns_f);
+    const size_t rows = static_cast<size_t>(rows_f);
+
+    auto cellOf = [&](const Position& p) -> size_t {
+        if (!std::isfinite(p.x) || !std::isfinite(p.z)) {
+            return 0;
+        }
+        size_t column = std::min(static_cast<size_t>((p.x - min_x) / cell_size), columns - 1);
+        size_t row = std::min(static_cast<size_t>((p.z - min_z) / cell_size), rows - 1);
+        return row * columns + column;
+    };
+
+    // Counting sort por célula. Os jogadores ficam nessa ordem também na
+    // saída: vizinhos próximos na memória deixam a distribuição local.
+    std::vector<uint32_t>& cell_offsets = scratch.cell_offsets;
+    cell_offsets.assign(columns * rows + 1, 0);
+    for (const Position& p : positions) {
+        ++cell_offsets[cellOf(p) + 1];
+    }
+    for (size_t c = 1; c < cell_offsets.size(); ++c) {
+        cell_offsets[c] += cell_offsets[c - 1];
+    }
+
+    scratch.cursor.assign(cell_offsets.begin(), cell_offsets.end() - 1);
+    for (const Position& p : positions) {
+        uint32_t index = scratch.cursor[cellOf(p)]++;
+        out.ids[index] = p.id;
+        out.xs[index] = p.x;
+        out.zs[index] = p.z;
+    }
+    out.buildIndex();
+
+    // O filtro de distância devolve estes índices
+    scratch.indices.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        scratch.indices[i] = static_cast<uint32_t>(i);
+    }
+
+    // Pares por linha de células. Cada célula compara os seus com os que
+    // vêm depois nela e na célula à direita (contíguos no CSR) e com as
+    // três células da linha de baixo (também contíguas): cada par de
+    // células vizinhas é visto uma única vez e vale para os dois lados.
+    // Duas passadas: a primeira conta os graus, a segunda refaz o filtro
+    // (barato, em SIMD) e escreve as listas, sem buffer de pares.
+    const float radius_sq = radius * radius;
+    std::vector<uint32_t>& offsets = out.offsets;
+
+    auto visitPairs = [&](size_t row, std::vector<uint32_t>& hits, auto&& onPairs) {
+        for (size_t column = 0; column < columns; ++column) {
+            size_t cell = row * columns + column;
+            uint32_t cell_end = cell_offsets[cell + 1];
+            uint32_t same_end = cell_offsets[column + 1 < columns ? cell + 2 : cell + 1];
+
+            uint32_t below_begin = 0;
+            uint32_t below_end = 0;
+            if (row + 1 < rows) {
+                size_t below = (row + 1) * columns;
+                below_begin = cell_offsets[below + (column > 0 ? column - 1 : 0)];
+                below_end = cell_offsets[below + std::min(column + 1, columns - 1) + 1];
+            }
+
+            for (uint32_t a = cell_offsets[cell]; a < cell_end; ++a) {
+                const float x = out.xs[a];
+                const float z = out.zs[a];
+                hits.resize((same_end - a - 1) + (below_end - below_begin));
+
+                size_t found = filterWithinRadius(scratch.indices.data() + a + 1, out.xs.data() + a + 1,
+                                                  out.zs.data() + a + 1, same_end - a - 1, x, z, radius_sq,
+                                                  hits.data());
+                found += filterWithinRadius(scratch.indices.data() + below_begin, out.xs.data() + below_begin,
+                                            out.zs.data() + below_begin, below_end - below_begin, x, z,
+                                            radius_sq, hits.data() + found);
+                onPairs(a, hits.data(), found);
+            }
+        }
+    };
+
+    // Linhas pares e depois ímpares: os pares de uma linha só tocam
+    // jogadores dela e da seguinte, então dentro de cada fase as threads
+    // escrevem em jogadores disjuntos, sem atomics, e a ordem de cada
+    // lista não depende do escalonamento.
+    // Até 4 blocos por thread, cada um com seu buffer de acertos no scratch.
+    const size_t max_chunks = 4 * (pool ? pool->getWorkerCount() + 1 : 1);
+    if (scratch.hits.size() < max_chunks) {
+        scratch.hits.resize(max_chunks);
+    }
+    auto forEachRowByParity = [&](auto&& onPairs) {
+        for (size_t parity = 0; parity < 2; ++parity) {
+            const size_t row_count = (rows + 1 - parity) / 2;
+            const size_t grain = std::max<size_t>(1, (row_count + max_chunks - 1) / max_chunks);
+            forRange(pool, row_count, [&](size_t begin, size_t end) {
+                std::vector<uint32_t>& hits = scratch.hits[begin / grain];
+                for (size_t row = parity + 2 * begin; row < parity + 2 * end && row < rows; row += 2) {
+                    visitPairs(row, hits, onPairs);
+                }
+            }, grain);
+        }
+    };
+
+    forEachRowByParity([&](uint32_t a, const uint32_t* hits, size_t found) {
+        offsets[a + 1] += static_cast<uint32_t>(found);
+        for (size_t k = 0; k < found; ++k) {
+            ++offsets[hits[k] + 1];
+        }
+    });
+
+    for (size_t i = 1; i <= count; ++i) {
+        offsets[i] += offsets[i - 1];
+    }
+
+    out.neighbors.resize(offsets[count]);
+    scratch.cursor.assign(offsets.begin(), offsets.end() - 1);
+    forEachRowByParity([&](uint32_t a, const uint32_t* hits, size_t found) {
+        uint32_t* own = out.neighbors.data() + scratch.cursor[a];
+        scratch.cursor[a] += static_cast<uint32_t>(found);
+        for (size_t k = 0; k < found; ++k) {
+            own[k] = out.ids[hits[k]];
+            out.neighbors[scratch.cursor[hits[k]]++] = out.ids[a];
+        }
+    });
+}
+
+std::unique_ptr<SpatialGrid> SpatialGrid::create(SpatialBackend backend, float cell_size, float world_size) {
+    if (backend == SpatialBackend::DENSE) {
+        if (DenseSpatialGrid::columnsFor(cell_size, world_size) != 0) {
+            return std::make_unique<DenseSpatialGrid>(cell_size, world_size);
+        }
+        Logger::warning("Dense spatial grid needs a positive world_size of at most " +
+                        std::to_string(DenseSpatialGrid::kMaxCells) + " cells, using HASH");
+    }
+    if (backend == SpatialBackend::QUADTREE) {
+        return std::make_unique<QuadtreeSpatialGrid>(cell_size, world_size);
+    }
+    return std::make_unique<HashSpatialGrid>(cell_size);
+}
+
+// ========== HashSpatialGrid ==========
+
+HashSpatialGrid::HashSpatialGrid(float cell_size) : cell_size_(cell_size) {}
+
+HashSpatialGrid::Cell HashSpatialGrid::getCell(float x, float z) const {
+    return Cell{
+        static_cast<int>(std::floor(x / cell_size_)),
+        static_cast<int>(std::floor(z / cell_size_))
+    };
+}
+
+void HashSpatialGrid::place(uint32_t player_id, Cell cell, float x, float z) {
+    Bucket& bucket = grid_[cell];
+    player_to_cell_[player_id] = Location{cell, &bucket, static_cast<uint32_t>(bucket.ids.size())};
+    bucket.ids.push_back(player_id);
+    bucket.xs.push_back(x);
+    bucket.zs.push_back(z);
+}
+
+void HashSpatialGrid::detach(const Location& location) {
+    // Troca com o último da célula para manter os vetores compactos
+    Bucket& bucket = *location.bucket;
+    size_t last = bucket.ids.size() - 1;
+    if (location.index != last) {
+        bucket.ids[location.index] = bucket.ids[last];
+        bucket.xs[location.index] = bucket.xs[last];
+        bucket.zs[location.index] = bucket.zs[last];
+        player_to_cell_[bucket.ids[location.index]].index = location.index;
+    }
+    bucket.ids.pop_back();
+    bucket.xs.pop_back();
+    bucket.zs.pop_back();
+
+    if (bucket.ids.empty()) {
+        grid_.erase(location.cell);
+    }
+}
+
+void HashSpatialGrid::insertPlayer(uint32_t player_id, float x, float z) {
+    std::unique_lock lock(mutex_);
+
+    auto it = player_to_cell_.find(player_id);
+    if (it != player_to_cell_.end()) {
+        detach(it->second);
+    }
+    place(player_id, getCell(x, z), x, z);
+}
+
+void HashSpatialGrid::removePlayer(uint32_t player_id) {
+    std::unique_lock lock(mutex_);
+
+    auto it = player_to_cell_.find(player_id);
+    if (it != player_to_cell_.end()) {
+        Location location = it->second;
+        player_to_cell_.erase(it);
+        detach(location);
+    }
+}
+
+void HashSpatialGrid::updatePlayer(uint32_t player_id, float x, float z) {
+    std::unique_lock lock(mutex_);
+
+    auto it = player_to_cell_.find(player_id);
+    if (it == player_to_cell_.end()) {
+        return;
+    }
+
+    Location& location = it->second;
+    Cell new_cell = getCell(x, z);
+
+    if (location.cell == new_cell) {
+        // Mesma célula: só a posição
+        location.bucket->xs[location.index] = x;
+        location.bucket->zs[location.index] = z;
+        return;
+    }
+
+    // Remove da célula antiga e adiciona na nova
+    detach(location);
+    place(player_id, new_cell, x, z);
+}
+
+size_t HashSpatialGrid::queryRadiusInto(float x, float z, float radius, std::vector<uint32_t>& out) {
+    std::shared_lock lock(mutex_);
+
+    out.clear();
+
+    // Calcula células que intersectam o raio
+    int cell_radius = static_cast<int>(std::ceil(radius / cell_size_));
+    Cell center = getCell(x, z);
+    float radius_sq = radius * radius;
+
+    for (int dx = -cell_radius; dx <= cell_radius; ++dx) {
+        for (int dz = -cell_radius; dz <= cell_radius; ++dz) {
+            Cell cell{center.x + dx, center.z + dz};
+
+            auto it = grid_.find(cell);
+            if (it != grid_.end()) {
+                const Bucket& bucket = it->second;
+                appendWithinRadius(bucket.ids.data(), bucket.xs.data(), bucket.zs.data(), bucket.ids.size(),
+                                   x, z, radius_sq, out);
+            }
+        }
+    }
+
+    return out.size();
+}
+
+void HashSpatialGrid::collectPositions(std::vector<Position>& out) {
+    std::shared_lock lock(mutex_);
+
+    out.reserve(out.size() + player_to_cell_.size());
+    for (const auto& [cell, bucket] : grid_) {
+        for (size_t i = 0; i < bucket.ids.size(); ++i) {
+            out.push_back(Position{bucket.ids[i], bucket.xs[i], bucket.zs[i]});
+        }
+    }
+}
+
+std::vector<uint32_t> HashSpatialGrid::queryArea(float min_x, float min_z, float max_x, float max_z) {
+    std::shared_lock lock(mutex_);
+
+    std::vector<uint32_t> result;
+
+    Cell min_cell = getCell(min_x, min_z);
+    Cell max_cell = getCell(max_x, max_z);
+
+    for (int x = min_cell.x; x <= max_cell.x; ++x) {
+        for (int z = min_cell.z; z <= max_cell.z; ++z) {
+            Cell cell{x, z};
+
+            auto it = grid_.find(cell);
+            if (it != grid_.end()) {
+                result.insert(result.end(), it->second.ids.begin(), it->second.ids.end());
+            }
+        }
+    }
+
+    return result;
+}
+
+// ========== DenseSpatialGrid ==========
+
+size_t DenseSpatialGrid::columnsFor(float cell_size, float world_size) {
+    if (!(cell_size > 0.0f) || !(world_size > 0.0f) || !std::isfinite(world_size)) {
+        return 0;
+    }
+    double columns = std::ceil(static_cast<double>(world_size) / cell_size);
+    if (columns * columns > static_cast<double>(kMaxCells)) {
+        return 0;
+    }
+    return static_cast<size_t>(columns);
+}
+
+DenseSpatialGrid::DenseSpatialGrid(float cell_size, float world_size)
+    : cell_size_(cell_size),
+      origin_(-0.5f * world_size),
+      columns_(static_cast<uint32_t>(std::max<size_t>(columnsFor(cell_size, world_size), 1))),
+      cell_offsets_(static_cast<size_t>(columns_) * columns_ + 1, 0) {}
+
+uint32_t DenseSpatialGrid::getColumn(float v) const {
+    float column = std::floor((v - origin_) / cell_size_);
+    // Também trata NaN
+    if (!(column > 0.0f)) {
+        return 0;
+    }
+    if (column >= static_cast<float>(columns_)) {
+        return columns_ - 1;
+    }
+    return static_cast<uint32_t>(column);
+}
+
+uint32_t DenseSpatialGrid::getCell(float x, float z) const {
+    return getColumn(z) * columns_ + getColumn(x);
+}
+
+void DenseSpatialGrid::insertPlayer(uint32_t player_id, float x, float z) {
+    std::unique_lock lock(mutex_);
+
+    players_.insert(player_id, Entry{getCell(x, z), 0, x, z});
+    dirty_.store(true, std::memory_order_release);
+}
+
+void DenseSpatialGrid::removePlayer(uint32_t player_id) {
+    std::unique_lock lock(mutex_);
+
+    if (players_.erase(player_id)) {
+        dirty_.store(true, std::memory_order_release);
+    }
+}
+
+void DenseSpatialGrid::updatePlayer(uint32_t player_id, float x, float z) {
+    std::unique_lock lock(mutex_);
+
+    Entry* entry = players_.find(player_id);
+    if (!entry) {
+        return;
+    }
+
+    entry->x = x;
+    entry->z = z;
+
+    uint32_t new_cell = getCell(x, z);
+    if (entry->cell != new_cell) {
+        entry->cell = new_cell;
+        dirty_.store(true, std::memory_order_release);
+    } else if (!dirty_.load(std::memory_order_relaxed)) {
+        // Mesma célula com o índice limpo: corrige a posição no lugar
+        cell_xs_[entry->index] = x;
+        cell_zs_[entry->index] = z;
+    }
+}
+
+std::shared_lock<std::shared_mutex> DenseSpatialGrid::lockBuilt() {
+    while (true) {
+        // dirty_ só muda sob o lock exclusivo: limpo aqui, limpo até soltar
+        std::shared_lock lock(mutex_);
+        if (!dirty_.load(std::memory_order_acquire)) {
+            return lock;
+        }
+        lock.unlock();
+
+        std::unique_lock write_lock(mutex_);
+        if (dirty_.load(std::memory_order_relaxed)) {
+            rebuild();
+        }
+    }
+}
+
+void DenseSpatialGrid::rebuild() {
+    // Counting sort por célula: contagens, prefixo e distribuição
+    std::fill(cell_offsets_.begin(), cell_offsets_.end(), 0);
+    for (const auto& entry : players_) {
+        ++cell_offsets_[entry.value.cell + 1];
+    }
+    for (size_t c = 1; c < cell_offsets_.size(); ++c) {
+        cell_offsets_[c] += cell_offsets_[c - 1];
+    }
+
+    cursor_.assign(cell_offsets_.begin(), cell_offsets_.end() - 1);
+    cell_ids_.resize(players_.size());
+    cell_xs_.resize(players_.size());
+    cell_zs_.resize(players_.size());
+    for (auto& [id, entry] : players_) {
+        entry.index = cursor_[entry.cell]++;
+        cell_ids_[entry.index] = id;
+        cell_xs_[entry.index] = entry.x;
+        cell_zs_[entry.index] = entry.z;
+    }
+
+    dirty_.store(false, std::memory_order_release);
+}
+
+void DenseSpatialGrid::appendCells(uint32_t min_col, uint32_t min_row, uint32_t max_col, uint32_t max_row,
+                                   std::vector<uint32_t>& out) const {
+    // As células de uma linha são contíguas em cell_ids_: um intervalo por linha
+    for (uint32_t row = min_row; row <= max_row; ++row) {
+        size_t first = static_cast<size_t>(row) * columns_;
+        const uint32_t* begin = cell_ids_.data() + cell_offsets_[first + min_col];
+        const uint32_t* end = cell_ids_.data() + cell_offsets_[first + max_col + 1];
+        out.insert(out.end(), begin, end);
+    }
+}
+
+size_t DenseSpatialGrid::queryRadiusInto(float x, float z, float radius, std::vector<uint32_t>& out) {
+    std::shared_lock lock = lockBuilt();
+
+    out.clear();
+
+    uint32_t min_col = getColumn(x - radius);
+    uint32_t max_col = getColumn(x + radius);
+    uint32_t min_row = getColumn(z - radius);
+    uint32_t max_row = getColumn(z + radius);
+    if (min_col > max_col || min_row > max_row) {
+        return 0;
+    }
+
+    // Um filtro SIMD por linha, sobre a faixa contígua das suas células
+    float radius_sq = radius * radius;
+    for (uint32_t row = min_row; row <= max_row; ++row) {
+        size_t first = static_cast<size_t>(row) * columns_;
+        uint32_t begin = cell_offsets_[first + min_col];
+        uint32_t end = cell_offsets_[first + max_col + 1];
+        appendWithinRadius(cell_ids_.data() + begin, cell_xs_.data() + begin, cell_zs_.data() + begin,
+                           end - begin, x, z, radius_sq, out);
+    }
+
+    return out.size();
+}
+
+void DenseSpatialGrid::collectPositions(std::vector<Position>& out) {
+    std::shared_lock lock(mutex_);
+
+    out.reserve(out.size() + players_.size());
+    for (const auto& [id, entry] : players_) {
+        out.push_back(Position{id, entry.x, entry.z});
+    }
+}
+
+std::vector<uint32_t> DenseSpatialGrid::queryArea(float min_x, float min_z, float max_x, float max_z) {
+    std::shared_lock lock = lockBuilt();
+
+    std::vector<uint32_t> result;
+
+    uint32_t min_col = getColumn(min_x);
+    uint32_t max_col = getColumn(max_x);
+    uint32_t min_row = getColumn(min_z);
+    uint32_t max_row = getColumn(max_z);
+    if (min_col > max_col || min_row > max_row) {
+        return result;
+    }
+
+    appendCells(min_col, min_row, max_col, max_row, result);
+    return result;
+}
+
+// ========== QuadtreeSpatialGrid ==========
+
+QuadtreeSpatialGrid::QuadtreeSpatialGrid(float cell_size, float world_size) {
+    float root_half = std::isfinite(world_size) && world_size > 0.0f ? 0.5f * world_size
+                                                                     : 0.5f * cell_size * kDefaultRootCells;
+    // Metades exatas (potências de 2), então a divisão para em min_half_
+    min_half_ = std::max(0.5f * cell_size, std::ldexp(root_half, -kMaxDepth));
+    nodes_.push_back(Node{0.0f, 0.0f, root_half, kNoNode, kNoNode, 0, {}, {}, {}});
+}
+
+bool QuadtreeSpatialGrid::fits(uint32_t node, float x, float z) const {
+    // A raiz fica com quem estiver fora do mundo
+    if (node == 0) {
+        return true;
+    }
+    const Node& n = nodes_[node];
+    float reach = n.half * kLooseness;
+    return std::abs(x - n.center_x) <= reach && std::abs(z - n.center_z) <= reach;
+}
+
+uint32_t QuadtreeSpatialGrid::childFor(uint32_t node, float x, float z) const {
+    const Node& n = nodes_[node];
+    return n.children + (x >= n.center_x ? 1u : 0u) + (z >= n.center_z ? 2u : 0u);
+}
+
+void QuadtreeSpatialGrid::append(uint32_t node, uint32_t player_id, float x, float z) {
+    Node& n = nodes_[node];
+    locations_[player_id] = Location{node, static_cast<uint32_t>(n.ids.size())};
+    n.ids.push_back(player_id);
+    n.xs.push_back(x);
+    n.zs.push_back(z);
+}
+
+void QuadtreeSpatialGrid::place(uint32_t player_id, float x, float z) {
+    // Desce enquanto o filho do quadrante aceitar a posição
+    uint32_t node = 0;
+    ++nodes_[node].subtree;
+    while (nodes_[node].children != kNoNode) {
+        uint32_t child = childFor(node, x, z);
+        if (!fits(child, x, z)) {
+            break;
+        }
+        node = child;
+        ++nodes_[node].subtree;
+    }
+    append(node, player_id, x, z);
+
+    const Node& n = nodes_[node];
+    if (n.children == kNoNode && n.ids.size() > kSplitThreshold && n.half > min_half_) {
+        split(node);
+    }
+}
+
+void QuadtreeSpatialGrid::detach(const Location& location) {
+    // Troca com o último do nó para manter os vetores compactos
+    Node& n = nodes_[location.node];
+    size_t last = n.ids.size() - 1;
+    if (location.index != last) {
+        n.ids[location.index] = n.ids[last];
+        n.xs[location.index] = n.xs[last];
+        n.zs[location.index] = n.zs[last];
+        locations_[n.ids[location.index]].index = location.index;
+    }
+    n.ids.pop_back();
+    n.xs.pop_back();
+    n.zs.pop_back();
+
+    // Junta a subárvore mais alta que ficou pequena
+    uint32_t merge = kNoNode;
+    for (uint32_t node = location.node; node != kNoNode; node = nodes_[node].parent) {
+        --nodes_[node].subtree;
+        if (nodes_[node].children != kNoNode && nodes_[node].subtree <= kMergeThreshold) {
+            merge = node;
+        }
+    }
+    if (merge != kNoNode) {
+        collapse(merge);
+    }
+}
+
+void QuadtreeSpatialGrid::split(uint32_t node) {
+    uint32_t first;
+    if (!free_blocks_.empty()) {
+        first = free_blocks_.back();
+        free_blocks_.pop_back();
+    } else {
+        first = static_cast<uint32_t>(nodes_.size());
+        nodes_.resize(nodes_.size() + 4);
+    }
+
+    const float half = 0.5f * nodes_[node].half;
+    const float center_x = nodes_[node].center_x;
+    const float center_z = nodes_[node].center_z;
+    for (uint32_t quadrant = 0; quadrant < 4; ++quadrant) {
+        Node& child = nodes_[first + quadrant];
+        child.center_x = center_x + ((quadrant & 1) ? half : -half);
+        child.center_z = center_z + ((quadrant & 2) ? half : -half);
+        child.half = half;
+        child.parent = node;
+        child.children = kNoNode;
+        child.subtree = 0;
+    }
+    nodes_[node].children = first;
+
+    // Redistribui; fica no nó só quem nenhum filho aceita
+    Node& n = nodes_[node];
+    size_t kept = 0;
+    for (size_t i = 0; i < n.ids.size(); ++i) {
+        uint32_t child = childFor(node, n.xs[i], n.zs[i]);
+        if (fits(child, n.xs[i], n.zs[i])) {
+            append(child, n.ids[i], n.xs[i], n.zs[i]);
+            ++nodes_[child].subtree;
+            continue;
+        }
+        n.ids[kept] = n.ids[i];
+        n.xs[kept] = n.xs[i];
+        n.zs[kept] = n.zs[i];
+        locations_[n.ids[kept]].index = static_cast<uint32_t>(kept);
+        ++kept;
+    }
+    n.ids.resize(kept);
+    n.xs.resize(kept);
+    n.zs.resize(kept);
+
+    // Todos no mesmo quadrante: continua descendo
+    for (uint32_t child = first; child < first + 4; ++child) {
+        if (nodes_[child].ids.size() > kSplitThreshold && nodes_[child].half > min_half_) {
+            split(child);
+        }
+    }
+}
+
+void QuadtreeSpatialGrid::releaseChildren(uint32_t node, std::vector<uint32_t>& ids, std::vector<float>& xs,
+                                          std::vector<float>& zs) {
+    uint32_t first = nodes_[node].children;
+    for (uint32_t child = first; child < first + 4; ++child) {
+        if (nodes_[child].children != kNoNode) {
+            releaseChildren(child, ids, xs, zs);
+        }
+        Node& c = nodes_[child];
+        ids.insert(ids.end(), c.ids.begin(), c.ids.end());
+        xs.insert(xs.end(), c.xs.begin(), c.xs.end());
+        zs.insert(zs.end(), c.zs.begin(), c.zs.end());
+        c.ids.clear();
+        c.xs.clear();
+        c.zs.clear();
+        c.subtree = 0;
+    }
+    nodes_[node].children = kNoNode;
+    free_blocks_.push_back(first);
+}
+
+void QuadtreeSpatialGrid::collapse(uint32_t node) {
+    Node& n = nodes_[node];
+    size_t begin = n.ids.size();
+    releaseChildren(node, n.ids, n.xs, n.zs);
+    for (size_t i = begin; i < n.ids.size(); ++i) {
+        locations_[n.ids[i]] = Location{node, static_cast<uint32_t>(i)};
+    }
+}
+
+void QuadtreeSpatialGrid::insertPlayer(uint32_t player_id, float x, float z) {
+    std::unique_lock lock(mutex_);
+
+    auto it = locations_.find(player_id);
+    if (it != locations_.end()) {
+        detach(it->second);
+    }
+    place(player_id, x, z);
+}
+
+void QuadtreeSpatialGrid::removePlayer(uint32_t player_id) {
+    std::unique_lock lock(mutex_);
+
+    auto it = locations_.find(player_id);
+    if (it != locations_.end()) {
+        Location location = it->second;
+        locations_.erase(it);
+        detach(location);
+    }
+}
+
+void QuadtreeSpatialGrid::updatePlayer(uint32_t player_id, float x, float z) {
+    std::unique_lock lock(mutex_);
+
+    auto it = locations_.find(player_id);
+    if (it == locations_.end()) {
+        return;
+    }
+
+    // Dentro da folga do nó (e sem caber num filho dele): só a posição
+    Location location = it->second;
+    const Node& n = nodes_[location.node];
+    if (fits(location.node, x, z) &&
+        (n.children == kNoNode || !fits(childFor(location.node, x, z), x, z))) {
+        nodes_[location.node].xs[location.index] = x;
+        nodes_[location.node].zs[location.index] = z;
+        return;
+    }
+
+    detach(location);
+    place(player_id, x, z);
+}
+
+template <typename Visit>
+void QuadtreeSpatialGrid::forEachNode(float min_x, float min_z, float max_x, float max_z, Visit&& visit) const {
+    // Cada nível empilha no máximo 3 irmãos além do que desce
+    uint32_t stack[3 * kMaxDepth + 4];
+    size_t top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const Node& n = nodes_[stack[--top]];
+        if (!n.ids.empty()) {
+            visit(n);
+        }
+        if (n.children == kNoNode) {
+            continue;
+        }
+        for (uint32_t child = n.children; child < n.children + 4; ++child) {
+            const Node& c = nodes_[child];
+            float reach = c.half * kLooseness;
+            if (c.subtree != 0 && c.center_x - reach <= max_x && c.center_x + reach >= min_x &&
+                c.center_z - reach <= max_z && c.center_z + reach >= min_z) {
+                stack[top++] = child;
+            }
+        }
+    }
+}
+
+size_t QuadtreeSpatialGrid::queryRadiusInto(float x, float z, float radius, std::vector<uint32_t>& out) {
+    std::shared_lock lock(mutex_);
+
+    out.clear();
+
+    float radius_sq = radius * radius;
+    forEachNode(x - radius, z - radius, x + radius, z + radius, [&](const Node& n) {
+        appendWithinRadius(n.ids.data(), n.xs.data(), n.zs.data(), n.ids.size(), x, z, radius_sq, out);
+    });
+
+    return out.size();
+}
+
+void QuadtreeSpatialGrid::collectPositions(std::vector<Position>& out) {
+    std::shared_lock lock(mutex_);
+
+    out.reserve(out.size() + locations_.size());
+    for (const Node& n : nodes_) {
+        for (size_t i = 0; i < n.ids.size(); ++i) {
+            out.push_back(Position{n.ids[i], n.xs[i], n.zs[i]});
+        }
+    }
+}
+
+std::vector<uint32_t> QuadtreeSpatialGrid::queryArea(float min_x, float min_z, float max_x, float max_z) {
+    std::shared_lock lock(mutex_);
+
+    // Nós inteiros, como as células dos outros backends
+    std::vector<uint32_t> result;
+    forEachNode(min_x, min_z, max_x, max_z, [&](const Node& n) {
+        result.insert(result.end(), n.ids.begin(), n.ids.end());
+    });
+    return result;
+}
+
+size_t QuadtreeSpatialGrid::getNodeCount() const {
+    std::shared_lock lock(mutex_);
+    return nodes_.size() - 4 * free_blocks_.size();
+}
@@ -0,0 +1,292 @@
+// include/server/SpatialGrid.h
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+#include "server/PeerTable.h"
+
+class ThreadPool;
+
+// Backend do índice espacial do World
+//   HASH      células num hash map, sem limites de mundo
+//   DENSE     array plano de células cobrindo game.world_size
+//   QUADTREE  loose quadtree, nós se dividem onde há muitos jogadores
+enum class SpatialBackend : uint8_t {
+    HASH = 0,
+    DENSE,
+    QUADTREE
+};
+
+// Vizinhos de todos os jogadores até 'radius', em CSR: os de ids[i] estão
+// em neighbors[offsets[i] .. offsets[i + 1]), sem o próprio. Os jogadores
+// vêm agrupados por célula e a ordem só depende das posições. Só leitura
+// até o próximo cálculo.
+struct NeighborLists {
+    static constexpr uint32_t kNoIndex = ~0u;
+
+    float radius = 0.0f;
+    std::vector<uint32_t> ids;
+    std::vector<float> xs;                // posição de cada ids[i] no cálculo
+    std::vector<float> zs;
+    std::vector<uint32_t> offsets;        // ids.size() + 1
+    std::vector<uint32_t> neighbors;
+    std::vector<uint32_t> index_by_slot;  // slot do handle -> índice em ids
+
+    size_t size() const { return ids.size(); }
+
+    std::span<const uint32_t> at(size_t index) const {
+        return std::span<const uint32_t>(neighbors.data() + offsets[index], offsets[index + 1] - offsets[index]);
+    }
+
+    // Índice do id em ids, ou kNoIndex se ele não estava no grid
+    size_t indexOf(uint32_t id) const;
+
+    // Vazio se o id não estava no grid
+    std::span<const uint32_t> find(uint32_t id) const;
+
+    // Refaz index_by_slot a partir de ids
+    void buildIndex();
+};
+
+// Spatial partitioning para otimizar queries espaciais (plano x/z). Cada
+// célula guarda as posições em SoA (xs/zs paralelos aos ids), e as
+// queries de raio fazem o teste de distância exato com SIMD.
+class SpatialGrid {
+public:
+    virtual ~SpatialGrid() = default;
+
+    virtual void insertPlayer(uint32_t player_id, float x, float z) = 0;
+    virtual void removePlayer(uint32_t player_id) = 0;
+    virtual void updatePlayer(uint32_t player_id, float x, float z) = 0;
+
+    // Ids a no máximo radius de (x, z), escritos em out (substitui o
+    // conteúdo, reaproveitando a capacidade). Retorna out.size().
+    virtual size_t queryRadiusInto(float x, float z, float radius, std::vector<uint32_t>& out) = 0;
+    std::vector<uint32_t> queryRadius(float x, float z, float radius);
+
+    // Todas as células que intersectam o retângulo, sem teste exato
+    virtual std::vector<uint32_t> queryArea(float min_x, float min_z, float max_x, float max_z) = 0;
+
+    // Vizinhos de todos até radius numa passada: cada par de células
+    // vizinhas é comparado uma vez e cada par achado vale para os dois
+    // lados. Com pool, as linhas de células são divididas entre as threads.
+    // Usa scratch interno: uma chamada por vez.
+    void computeNeighbors(float radius, NeighborLists& out, ThreadPool* pool = nullptr);
+
+    // DENSE sem world_size utilizável cai para HASH
+    static std::unique_ptr<SpatialGrid> create(SpatialBackend backend, float cell_size, float world_size);
+
+protected:
+    struct Position {
+        uint32_t id;
+        float x, z;
+    };
+
+    // Cópia das posições atuais, em qualquer ordem
+    virtual void collectPositions(std::vector<Position>& out) = 0;
+
+private:
+    // Scratch de computeNeighbors, preservado entre ticks
+    struct NeighborScratch {
+        std::vector<Position> positions;
+        std::vector<uint32_t> cell_offsets;
+        std::vector<uint32_t> indices;              // 0, 1, 2... para o filtro de distância
+        std::vector<uint32_t> cursor;
+        std::vector<std::vector<uint32_t>> hits;    // um por bloco de linhas
+    };
+    NeighborScratch neighbor_scratch_;
+};
+
+// Uma célula por entrada do hash map, cada uma com seus próprios vetores
+class HashSpatialGrid : public SpatialGrid {
+public:
+    explicit HashSpatialGrid(float cell_size = 50.0f);
+
+    void insertPlayer(uint32_t player_id, float x, float z) override;
+    void removePlayer(uint32_t player_id) override;
+    void updatePlayer(uint32_t player_id, float x, float z) override;
+
+    size_t queryRadiusInto(float x, float z, float radius, std::vector<uint32_t>& out) override;
+    std::vector<uint32_t> queryArea(float min_x, float min_z, float max_x, float max_z) override;
+
+protected:
+    void collectPositions(std::vector<Position>& out) override;
+
+private:
+    struct Cell {
+        int x, z;
+
+        bool operator==(const Cell& other) const {
+            return x == other.x && z == other.z;
+        }
+    };
+
+    // Mistura as duas coordenadas; o XOR simples colidia nas diagonais
+    struct CellHash {
+        size_t operator()(const Cell& cell) const {
+            uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(cell.x)) << 32) |
+                           static_cast<uint32_t>(cell.z);
+            key *= 0x9E3779B97F4A7C15ull;
+            return static_cast<size_t>(key ^ (key >> 32));
+        }
+    };
+
+    struct Bucket {
+        std::vector<uint32_t> ids;
+        std::vector<float> xs;
+        std::vector<float> zs;
+    };
+
+    // Nós do unordered_map não mudam de endereço, então o Bucket* vale
+    // até a célula ser apagada
+    struct Location {
+        Cell cell;
+        Bucket* bucket;
+        uint32_t index;   // em bucket->ids
+    };
+
+    Cell getCell(float x, float z) const;
+    void place(uint32_t player_id, Cell cell, float x, float z);
+    void detach(const Location& location);
+
+    float cell_size_;
+    std::unordered_map<Cell, Bucket, CellHash> grid_;
+    std::unordered_map<uint32_t, Location> player_to_cell_;
+    mutable std::shared_mutex mutex_;
+};
+
+// Grade densa para mundo limitado: quadrado de world_size centrado na
+// origem, células em ordem de linha (z) e ids em layout CSR, com os da
+// célula c em cell_ids_[cell_offsets_[c] .. cell_offsets_[c + 1]).
+// Posições fora do mundo caem na célula da borda.
+//
+// Mover dentro da mesma célula só corrige a posição no lugar; trocar de
+// célula, entrar ou sair marca o índice como sujo, e ele é reconstruído
+// (counting sort) uma vez na próxima query. Os ids são handles de peer.
+class DenseSpatialGrid : public SpatialGrid {
+public:
+    // Limite de células (4M: 16 MB de offsets)
+    static constexpr size_t kMaxCells = size_t{1} << 22;
+
+    DenseSpatialGrid(float cell_size, float world_size);
+
+    void insertPlayer(uint32_t player_id, float x, float z) override;
+    void removePlayer(uint32_t player_id) override;
+    void updatePlayer(uint32_t player_id, float x, float z) override;
+
+    size_t queryRadiusInto(float x, float z, float radius, std::vector<uint32_t>& out) override;
+    std::vector<uint32_t> queryArea(float min_x, float min_z, float max_x, float max_z) override;
+
+    size_t getCellCount() const { return cell_offsets_.size() - 1; }
+
+    // Colunas por lado para o mundo dado (0 se world_size não for utilizável)
+    static size_t columnsFor(float cell_size, float world_size);
+
+protected:
+    void collectPositions(std::vector<Position>& out) override;
+
+private:
+    struct Entry {
+        uint32_t cell;
+        uint32_t index;   // em cell_ids_, válido com o índice limpo
+        float x, z;
+    };
+
+    uint32_t getColumn(float v) const;
+    uint32_t getCell(float x, float z) const;
+    // Shared lock com o índice limpo: reconstrói (sob o lock exclusivo) e
+    // tenta de novo se um writer sujou o índice entre os dois locks
+    std::shared_lock<std::shared_mutex> lockBuilt();
+    void rebuild();
+    void appendCells(uint32_t min_col, uint32_t min_row, uint32_t max_col, uint32_t max_row,
+                     std::vector<uint32_t>& out) const;
+
+    float cell_size_;
+    float origin_;
+    uint32_t columns_;
+    PeerTable<Entry> players_;
+    std::vector<uint32_t> cell_offsets_; // células + 1
+    std::vector<uint32_t> cell_ids_;
+    std::vector<float> cell_xs_;         // paralelos a cell_ids_
+    std::vector<float> cell_zs_;
+    std::vector<uint32_t> cursor_;       // scratch do rebuild
+    std::atomic<bool> dirty_{false};
+    mutable std::shared_mutex mutex_;
+};
+
+// Loose quadtree para densidade irregular (cidades cheias, mapa vazio).
+// Cada nó cobre um quadrado mas aceita jogadores no dobro dele, então
+// quem anda pouco não troca de nó. Um nó com mais de kSplitThreshold
+// jogadores se divide em 4 até o lado mínimo cell_size; quando uma
+// subárvore cai para kMergeThreshold ela volta a ser uma folha.
+//
+// A raiz cobre world_size centrado na origem (ou kDefaultRootCells
+// células sem ele) e fica com quem estiver fora.
+class QuadtreeSpatialGrid : public SpatialGrid {
+public:
+    static constexpr size_t kSplitThreshold = 16;
+    static constexpr size_t kMergeThreshold = 8;
+    static constexpr float kLooseness = 2.0f;
+    static constexpr float kDefaultRootCells = 1024.0f;
+    static constexpr int kMaxDepth = 20;   // limita o lado mínimo quando cell_size é pequeno
+
+    QuadtreeSpatialGrid(float cell_size, float world_size = 0.0f);
+
+    void insertPlayer(uint32_t player_id, float x, float z) override;
+    void removePlayer(uint32_t player_id) override;
+    void updatePlayer(uint32_t player_id, float x, float z) override;
+
+    size_t queryRadiusInto(float x, float z, float radius, std::vector<uint32_t>& out) override;
+    std::vector<uint32_t> queryArea(float min_x, float min_z, float max_x, float max_z) override;
+
+    size_t getNodeCount() const;
+
+protected:
+    void collectPositions(std::vector<Position>& out) override;
+
+private:
+    static constexpr uint32_t kNoNode = ~0u;
+
+    // Filhos alocados em blocos de 4 contíguos em nodes_
+    struct Node {
+        float center_x, center_z;
+        float half;                  // metade do lado, sem a folga
+        uint32_t parent;
+        uint32_t children;           // primeiro dos 4 filhos, kNoNode na folha
+        uint32_t subtree;            // jogadores no nó e abaixo dele
+        std::vector<uint32_t> ids;
+        std::vector<float> xs;       // paralelos a ids
+        std::vector<float> zs;
+    };
+
+    struct Location {
+        uint32_t node;
+        uint32_t index;   // em nodes_[node].ids
+    };
+
+    bool fits(uint32_t node, float x, float z) const;
+    uint32_t childFor(uint32_t node, float x, float z) const;
+    void place(uint32_t player_id, float x, float z);
+    void append(uint32_t node, uint32_t player_id, float x, float z);
+    void detach(const Location& location);
+    void split(uint32_t node);
+    void collapse(uint32_t node);
+    void releaseChildren(uint32_t node, std::vector<uint32_t>& ids, std::vector<float>& xs,
+                         std::vector<float>& zs);
+
+    // Chama visit(node) para cada nó não vazio cujos limites frouxos
+    // intersectam o retângulo
+    template <typename Visit>
+    void forEachNode(float min_x, float min_z, float max_x, float max_z, Visit&& visit) const;
+
+    float min_half_;
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> free_blocks_;
+    std::unordered_map<uint32_t, Location> locations_;
+    mutable std::shared_mutex mutex_;
+};
@@ -0,0 +1,198 @@
+// src/server/TickScheduler.cpp
+#include "server/TickScheduler.h"
+#include "utils/Logger.h"
+#include "utils/PerformanceMonitor.h"
+#include <thread>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <cstring>
+#include <cerrno>
+#endif
+
+TickScheduler::TickScheduler(float tick_rate, uint32_t spin_us)
+    : period_(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / tick_rate))),
+      spin_(std::chrono::microseconds(spin_us)) {}
+
+TickScheduler::~TickScheduler() {
+#ifdef __linux__
+    if (epoll_fd_ >= 0) close(epoll_fd_);
+    if (timer_fd_ >= 0) close(timer_fd_);
+    if (event_fd_ >= 0) close(event_fd_);
+#endif
+}
+
+bool TickScheduler::initialize() {
+    start();
+
+#ifdef __linux__
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd_ < 0 || timer_fd_ < 0 || event_fd_ < 0) {
+        Logger::error("Failed to create tick scheduler descriptors: " + std::string(std::strerror(errno)));
+        return false;
+    }
+
+    for (int fd : {timer_fd_, event_fd_}) {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            Logger::error("Failed to register tick scheduler descriptor: " + std::string(std::strerror(errno)));
+            return false;
+        }
+    }
+#endif
+    return true;
+}
+
+void TickScheduler::start() {
+    last_tick_ = Clock::now();
+    deadline_ = last_tick_;
+}
+
+bool TickScheduler::watchSocket(ENetSocket socket) {
+#ifdef __linux__
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = socket;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, socket, &ev) != 0) {
+        Logger::error("Failed to watch socket: " + std::string(std::strerror(errno)));
+        return false;
+    }
+#else
+    sockets_.push_back(socket);
+#endif
+    return true;
+}
+
+void TickScheduler::notify() {
+#ifdef __linux__
+    uint64_t one = 1;
+    ssize_t written = write(event_fd_, &one, sizeof(one));
+    (void)written;   // EAGAIN só com o contador saturado: já há wake pendente
+#else
+    {
+        std::lock_guard<std::mutex> lock(notify_mutex_);
+        notified_ = true;
+    }
+    notify_cv_.notify_one();
+#endif
+}
+
+bool TickScheduler::wait() {
+    if (Clock::now() >= deadline_) {
+        return true;
+    }
+
+    // Bloqueia até um pouco antes do deadline; o resto é spin
+    Clock::time_point wake_time = deadline_ - spin_;
+    woke_early_ = false;
+    if (Clock::now() < wake_time) {
+        waitUntil(wake_time);
+        if (woke_early_) {
+            PerformanceMonitor::getInstance().recordTrafficWakeup();
+            return false;
+        }
+
+        // Quanto o kernel atrasou em relação ao pedido
+        auto late = Clock::now() - wake_time;
+        PerformanceMonitor::getInstance().recordWakeLatency(
+            std::chrono::duration<double, std::micro>(late).count());
+    }
+
+    spinUntil(deadline_);
+    return true;
+}
+
+float TickScheduler::beginTick() {
+    Clock::time_point now = Clock::now();
+    PerformanceMonitor::getInstance().recordTickJitter(
+        std::chrono::duration<double, std::micro>(now - deadline_).count());
+
+    float delta_time = std::chrono::duration<float>(now - last_tick_).count();
+    last_tick_ = now;
+
+    // Atrasado mais de um período (tick longo): realinha em vez de
+    // disparar uma rajada de ticks para recuperar
+    deadline_ += period_;
+    if (deadline_ <= now) {
+        deadline_ = now + period_;
+    }
+    return delta_time;
+}
+
+void TickScheduler::spinUntil(Clock::time_point deadline) {
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+#ifdef __linux__
+void TickScheduler::waitUntil(Clock::time_point wake_time) {
+    // steady_clock é CLOCK_MONOTONIC no Linux
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(wake_time.time_since_epoch()).count();
+    itimerspec spec{};
+    spec.it_value.tv_sec = static_cast<time_t>(ns / 1000000000);
+    spec.it_value.tv_nsec = static_cast<long>(ns % 1000000000);
+    timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+
+    epoll_event events[16];
+    for (;;) {
+        int count = epoll_wait(epoll_fd_, events, 16, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                // Sinal (ex.: shutdown): devolve o controle ao loop
+                woke_early_ = true;
+                return;
+            }
+            Logger::error("epoll_wait failed: " + std::string(std::strerror(errno)));
+            std::this_thread::sleep_until(wake_time);
+            return;
+        }
+
+        bool timer_fired = false;
+        for (int i = 0; i < count; ++i) {
+            uint64_t value;
+            if (events[i].data.fd == timer_fd_) {
+                timer_fired = read(timer_fd_, &value, sizeof(value)) > 0;
+            } else if (events[i].data.fd == event_fd_) {
+                ssize_t consumed = read(event_fd_, &value, sizeof(value));
+                (void)consumed;
+                woke_early_ = true;
+            } else {
+                // Socket com dados: quem lê é o pollEvents
+                woke_early_ = true;
+            }
+        }
+
+        if (woke_early_ || timer_fired) {
+            // Tráfego junto com o timer conta como tick
+            woke_early_ = woke_early_ && !timer_fired;
+            return;
+        }
+    }
+}
+#else
+void TickScheduler::waitUntil(Clock::time_point wake_time) {
+    if (sockets_.size() == 1) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(wake_time - Clock::now());
+        enet_uint32 condition = ENET_SOCKET_WAIT_RECEIVE;
+        if (remaining.count() > 0 &&
+            enet_socket_wait(sockets_[0], &condition, static_cast<enet_uint32>(remaining.count())) == 0 &&
+            (condition & ENET_SOCKET_WAIT_RECEIVE)) {
+            woke_early_ = true;
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(notify_mutex_);
+    notify_cv_.wait_until(lock, wake_time, [this] { return notified_; });
+    woke_early_ = notified_;
+    notified_ = false;
+}
+#endif
@@ -0,0 +1,69 @@
+// include/server/TickScheduler.h
+#pragma once
+
+#include <enet/enet.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Relógio do loop principal. wait() bloqueia até o próximo tick vencer ou
+// até chegar tráfego, o que vier primeiro, para que a entrada seja
+// processada assim que chega e não só no tick seguinte.
+//
+// No Linux espera com epoll sobre os sockets observados, um eventfd
+// (notify) e um timerfd armado no deadline menos spin_us; o restante é
+// feito em spin para não depender da folga do timer do kernel. Nas demais
+// plataformas usa enet_socket_wait (um socket) ou uma condition variable,
+// com o mesmo spin no fim.
+class TickScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit TickScheduler(float tick_rate, uint32_t spin_us = 200);
+    ~TickScheduler();
+
+    TickScheduler(const TickScheduler&) = delete;
+    TickScheduler& operator=(const TickScheduler&) = delete;
+
+    bool initialize();
+    // Zera o relógio: o primeiro tick vence imediatamente (chamar ao
+    // entrar no loop, para o delta não incluir a inicialização)
+    void start();
+
+    // Acorda wait() quando o socket tiver dados (chamar antes do loop)
+    bool watchSocket(ENetSocket socket);
+
+    // Acorda wait() de qualquer thread (ex.: threads de I/O da rede)
+    void notify();
+
+    // true se o tick venceu; false se acordou por tráfego antes dele
+    bool wait();
+
+    // Marca o início do tick, agenda o próximo e retorna o delta em segundos
+    float beginTick();
+
+private:
+    void waitUntil(Clock::time_point wake_time);
+    void spinUntil(Clock::time_point deadline);
+
+    Clock::duration period_;
+    Clock::duration spin_;
+    Clock::time_point deadline_;
+    Clock::time_point last_tick_;
+
+    // Acordado por tráfego/notify na última espera
+    bool woke_early_ = false;
+
+#ifdef __linux__
+    int epoll_fd_ = -1;
+    int timer_fd_ = -1;
+    int event_fd_ = -1;
+#else
+    std::vector<ENetSocket> sockets_;
+    std::mutex notify_mutex_;
+    std::condition_variable notify_cv_;
+    bool notified_ = false;
+#endif
+};
@@ -0,0 +1,139 @@
+// include/server/Variant.h
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include "utils/Arena.h"
+#include "utils/Structs.h"
+
+struct VariantPair;
+
+// Argumento de RPC (subconjunto dos tipos do Godot) como união marcada de
+// 24 bytes. Escalares, Vector3 e strings de até kInlineStringSize bytes
+// ficam inline; strings maiores, arrays e dicionários apontam para memória
+// de fora (o buffer do pacote ou uma Arena). O Variant é trivialmente
+// copiável e só é válido enquanto essa memória existir: nos handlers de
+// RPC, durante a chamada.
+struct Variant
+{
+    enum Type : uint8_t
+    {
+        NIL = 0,
+        BOOL = 1,
+        INT = 2,
+        FLOAT = 3,
+        STRING = 4,
+        VECTOR3 = 5,
+        ARRAY = 6,
+        DICTIONARY = 7
+    };
+
+    static constexpr size_t kInlineStringSize = 16;
+
+    Type type = NIL;
+
+    Variant() : i_(0) {}
+    Variant(bool val) : type(BOOL), b_(val) {}
+    Variant(int val) : type(INT), i_(val) {}
+    Variant(int64_t val) : type(INT), i_(val) {}
+    Variant(double val) : type(FLOAT), f_(val) {}
+    Variant(const Vector3 &val) : type(VECTOR3), v3_(val) {}
+
+    // String inline se couber; senão referencia 's', que precisa viver
+    // tanto quanto o Variant
+    static Variant stringView(std::string_view s) {
+        Variant v;
+        v.type = STRING;
+        v.size_ = static_cast<uint32_t>(s.size());
+        if (s.size() <= kInlineStringSize) {
+            std::memcpy(v.small_, s.data(), s.size());
+        } else {
+            v.str_ = s.data();
+        }
+        return v;
+    }
+
+    // String inline se couber; senão copiada para a arena
+    static Variant string(std::string_view s, Arena &arena) {
+        if (s.size() <= kInlineStringSize) {
+            return stringView(s);
+        }
+        char *copy = arena.allocate<char>(s.size());
+        std::memcpy(copy, s.data(), s.size());
+        return stringView(std::string_view(copy, s.size()));
+    }
+
+    // Referenciam os itens (em geral alocados na arena)
+    static Variant array(std::span<const Variant> items) {
+        Variant v;
+        v.type = ARRAY;
+        v.size_ = static_cast<uint32_t>(items.size());
+        v.items_ = items.data();
+        return v;
+    }
+
+    static Variant dictionary(std::span<const VariantPair> pairs);
+
+    // ========== Acesso ==========
+    bool asBool() const { return b_; }
+    int64_t asInt() const { return i_; }
+    double asFloat() const { return f_; }
+    const Vector3 &asVector3() const { return v3_; }
+
+    std::string_view asString() const {
+        return size_ <= kInlineStringSize ? std::string_view(small_, size_) : std::string_view(str_, size_);
+    }
+
+    std::span<const Variant> asArray() const { return {items_, size_}; }
+    std::span<const VariantPair> asDictionary() const;
+
+    // Valor da chave num dicionário (busca linear), ou nullptr
+    const Variant *find(std::string_view key) const;
+
+private:
+    uint32_t size_ = 0;   // bytes da string ou número de itens
+    union
+    {
+        bool b_;
+        int64_t i_;
+        double f_;
+        Vector3 v3_;
+        char small_[kInlineStringSize];
+        const char *str_;
+        const Variant *items_;
+        const VariantPair *pairs_;
+    };
+};
+
+struct VariantPair
+{
+    Variant key;      // STRING
+    Variant value;
+};
+
+static_assert(sizeof(Variant) == 24, "Variant should stay compact");
+static_assert(std::is_trivially_copyable_v<Variant>);
+
+inline Variant Variant::dictionary(std::span<const VariantPair> pairs) {
+    Variant v;
+    v.type = DICTIONARY;
+    v.size_ = static_cast<uint32_t>(pairs.size());
+    v.pairs_ = pairs.data();
+    return v;
+}
+
+inline std::span<const VariantPair> Variant::asDictionary() const {
+    return {pairs_, size_};
+}
+
+inline const Variant *Variant::find(std::string_view key) const {
+    for (const VariantPair &pair : asDictionary()) {
+        if (pair.key.asString() == key) {
+            return &pair.value;
+        }
+    }
+    return nullptr;
+}
@@ -6,47 +6,18 @@
 #include <memory>
 #include <mutex>
 #include <shared_mutex>
+#include "server/SpatialGrid.h"
+#include "utils/ThreadPool.h"
 
 class Player;
 
-// Spatial partitioning para otimizar queries espaciais
-class SpatialGrid {
-public:
-    SpatialGrid(float cell_size = 50.0f);
-    
-    void insertPlayer(uint32_t player_id, float x, float z);
-    void removePlayer(uint32_t player_id);
-    void updatePlayer(uint32_t player_id, float x, float z);
-    
-    std::vector<uint32_t> queryRadius(float x, float z, float radius);
-    std::vector<uint32_t> queryArea(float min_x, float min_z, float max_x, float max_z);
-
-private:
-    struct Cell {
-        int x, z;
-        
-        bool operator==(const Cell& other) const {
-            return x == other.x && z == other.z;
-        }
-    };
-    
-    struct CellHash {
-        size_t operator()(const Cell& cell) const {
-            return std::hash<int>()(cell.x) ^ (std::hash<int>()(cell.z) << 1);
-        }
-    };
-    
-    Cell getCell(float x, float z) const;
-    
-    float cell_size_;
-    std::unordered_map<Cell, std::vector<uint32_t>, CellHash> grid_;
-    std::unordered_map<uint32_t, Cell> player_to_cell_;
-    mutable std::shared_mutex mutex_;
-};
-
 class World {
 public:
-    World();
+    // world_size limita DENSE e a raiz do QUADTREE (0 = sem limite);
+    // neighbor_threads são os workers extras de computeNeighbors (0 = só
+    // a thread que chama)
+    explicit World(SpatialBackend spatial_backend = SpatialBackend::HASH, float cell_size = 50.0f,
+                   float world_size = 0.0f, size_t neighbor_threads = 0);
     
     void update(float delta_time);
     
@@ -54,11 +25,30 @@ public:
     void removePlayer(uint32_t player_id);
     
     std::vector<std::shared_ptr<Player>> getPlayersInRadius(float x, float z, float radius);
+    // Só os ids, sem buscar os Player nem copiar shared_ptr
+    size_t getPlayerIdsInRadius(float x, float z, float radius, std::vector<uint32_t>& out) {
+        return spatial_grid_->queryRadiusInto(x, z, radius, out);
+    }
     
-    SpatialGrid* getSpatialGrid() { return &spatial_grid_; }
+    SpatialGrid* getSpatialGrid() { return spatial_grid_.get(); }
+
+    // Vizinhos de todos os jogadores até radius, calculados no pool. As
+    // listas são lidas sem lock até a próxima chamada.
+    const NeighborLists& computeNeighbors(float radius);
+    const NeighborLists& getNeighbors() const { return neighbors_; }
+
+    // Chamado por Player::setPosition; cada jogador entra uma vez por tick
+    void markMoved(Player& player);
 
 private:
-    SpatialGrid spatial_grid_;
+    std::unique_ptr<SpatialGrid> spatial_grid_;
+    ThreadPool neighbor_pool_;
+    NeighborLists neighbors_;
     std::unordered_map<uint32_t, std::shared_ptr<Player>> players_;
     mutable std::shared_mutex players_mutex_;
+
+    // Jogadores que se moveram desde o último update. Ordem dos locks:
+    // players_mutex_, moved_mutex_, mutex do grid.
+    std::vector<uint32_t> moved_;
+    std::mutex moved_mutex_;
 };
\ No newline at end of file
@@ -0,0 +1,79 @@
+// include/utils/Arena.h
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Alocador monotônico: aloca avançando um ponteiro dentro de blocos e
+// libera tudo de uma vez em reset(). Os blocos são mantidos entre resets,
+// então em regime o uso não aloca. Destrutores não são chamados: só para
+// tipos trivialmente destrutíveis e dados de vida curta (ex.: argumentos
+// de um RPC durante o dispatch).
+class Arena {
+public:
+    explicit Arena(size_t block_size = 4096) : block_size_(block_size) {}
+
+    Arena(Arena&&) noexcept = default;
+    Arena& operator=(Arena&&) noexcept = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size, size_t align) {
+        while (current_ < blocks_.size()) {
+            Block& block = blocks_[current_];
+            size_t offset = alignUp(offset_, align);
+            if (offset + size <= block.size) {
+                offset_ = offset + size;
+                return block.data.get() + offset;
+            }
+            ++current_;
+            offset_ = 0;
+        }
+
+        // Nenhum bloco livre comporta: cria um (grande o bastante para
+        // alocações maiores que o tamanho padrão)
+        size_t block_size = std::max(block_size_, size + align);
+        blocks_.push_back(Block{std::make_unique<std::byte[]>(block_size), block_size});
+        current_ = blocks_.size() - 1;
+        offset_ = alignUp(0, align) + size;
+        return blocks_.back().data.get() + alignUp(0, align);
+    }
+
+    template<typename T>
+    T* allocate(size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "Arena does not run destructors");
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    void reset() {
+        current_ = 0;
+        offset_ = 0;
+    }
+
+    size_t getCapacity() const {
+        size_t total = 0;
+        for (const Block& block : blocks_) {
+            total += block.size;
+        }
+        return total;
+    }
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+
+    static size_t alignUp(size_t value, size_t align) {
+        return (value + align - 1) & ~(align - 1);
+    }
+
+    size_t block_size_;
+    std::vector<Block> blocks_;
+    size_t current_ = 0;   // bloco em uso
+    size_t offset_ = 0;    // próximo byte livre nele
+};
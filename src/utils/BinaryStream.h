@@ -0,0 +1,175 @@
+// include/utils/BinaryStream.h
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Serialização binária little-endian com varints (LEB128) e zigzag
+// para inteiros com sinal. Usado pelos snapshots e pelos formatos
+// internos de rede.
+
+inline uint32_t zigzagEncode(int32_t v) {
+    return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31);
+}
+
+inline int32_t zigzagDecode(uint32_t v) {
+    return static_cast<int32_t>(v >> 1) ^ -static_cast<int32_t>(v & 1);
+}
+
+// Bytes ocupados por writeVarUInt(v)
+inline size_t varUIntSize(uint64_t v) {
+    size_t n = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        ++n;
+    }
+    return n;
+}
+
+class BinaryWriter {
+public:
+    explicit BinaryWriter(std::vector<uint8_t>& buf) : buf_(buf) {}
+
+    void writeU8(uint8_t v) { buf_.push_back(v); }
+
+    void writeU16(uint16_t v) {
+        buf_.push_back(static_cast<uint8_t>(v));
+        buf_.push_back(static_cast<uint8_t>(v >> 8));
+    }
+
+    void writeU32(uint32_t v) {
+        for (int i = 0; i < 4; ++i)
+            buf_.push_back(static_cast<uint8_t>(v >> (i * 8)));
+    }
+
+    void writeU64(uint64_t v) {
+        for (int i = 0; i < 8; ++i)
+            buf_.push_back(static_cast<uint8_t>(v >> (i * 8)));
+    }
+
+    void writeFloat(float v) {
+        uint32_t u;
+        std::memcpy(&u, &v, 4);
+        writeU32(u);
+    }
+
+    void writeVarUInt(uint32_t v) {
+        while (v >= 0x80) {
+            buf_.push_back(static_cast<uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        buf_.push_back(static_cast<uint8_t>(v));
+    }
+
+    void writeVarInt(int32_t v) { writeVarUInt(zigzagEncode(v)); }
+
+    void writeString(std::string_view s) {
+        writeVarUInt(static_cast<uint32_t>(s.size()));
+        writeBytes(s.data(), s.size());
+    }
+
+    void writeBytes(const void* data, size_t len) {
+        const auto* p = static_cast<const uint8_t*>(data);
+        buf_.insert(buf_.end(), p, p + len);
+    }
+
+    // Sobrescreve um u16 já escrito (para contadores conhecidos só no fim)
+    void patchU16(size_t offset, uint16_t v) {
+        buf_[offset] = static_cast<uint8_t>(v);
+        buf_[offset + 1] = static_cast<uint8_t>(v >> 8);
+    }
+
+    size_t size() const { return buf_.size(); }
+    std::vector<uint8_t>& buffer() { return buf_; }
+
+private:
+    std::vector<uint8_t>& buf_;
+};
+
+class BinaryReader {
+public:
+    BinaryReader(const uint8_t* data, size_t len) : ptr_(data), end_(data + len) {}
+
+    uint8_t readU8() {
+        require(1, "u8");
+        return *ptr_++;
+    }
+
+    uint16_t readU16() {
+        require(2, "u16");
+        uint16_t v = static_cast<uint16_t>(ptr_[0] | (ptr_[1] << 8));
+        ptr_ += 2;
+        return v;
+    }
+
+    uint32_t readU32() {
+        require(4, "u32");
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i)
+            v |= static_cast<uint32_t>(ptr_[i]) << (i * 8);
+        ptr_ += 4;
+        return v;
+    }
+
+    uint64_t readU64() {
+        require(8, "u64");
+        uint64_t v = 0;
+        for (int i = 0; i < 8; ++i)
+            v |= static_cast<uint64_t>(ptr_[i]) << (i * 8);
+        ptr_ += 8;
+        return v;
+    }
+
+    float readFloat() {
+        uint32_t u = readU32();
+        float v;
+        std::memcpy(&v, &u, 4);
+        return v;
+    }
+
+    uint32_t readVarUInt() {
+        uint32_t v = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            uint8_t b = readU8();
+            v |= static_cast<uint32_t>(b & 0x7F) << shift;
+            if ((b & 0x80) == 0)
+                return v;
+        }
+        throw std::runtime_error("Malformed varint");
+    }
+
+    int32_t readVarInt() { return zigzagDecode(readVarUInt()); }
+
+    std::string_view readString() {
+        uint32_t len = readVarUInt();
+        require(len, "string data");
+        std::string_view s(reinterpret_cast<const char*>(ptr_), len);
+        ptr_ += len;
+        return s;
+    }
+
+    // Avança n bytes e retorna o início deles (sem cópia)
+    const uint8_t* readBytes(size_t n) {
+        require(n, "bytes");
+        const uint8_t* p = ptr_;
+        ptr_ += n;
+        return p;
+    }
+
+    const uint8_t* position() const { return ptr_; }
+    size_t remaining() const { return static_cast<size_t>(end_ - ptr_); }
+    bool empty() const { return ptr_ >= end_; }
+
+private:
+    void require(size_t n, const char* what) const {
+        if (static_cast<size_t>(end_ - ptr_) < n)
+            throw std::runtime_error(std::string("EOF while reading ") + what);
+    }
+
+    const uint8_t* ptr_;
+    const uint8_t* end_;
+};
@@ -1,7 +1,9 @@
 // include/utils/Config.h
 #pragma once
 
+#include <map>
 #include <string>
+#include <vector>
 #include <nlohmann/json.hpp>
 
 class Config {
@@ -14,14 +16,58 @@ public:
     uint16_t getPort() const { return config_["server"]["port"]; }
     size_t getMaxClients() const { return config_["server"]["max_clients"]; }
     int getTickRate() const { return config_["server"]["tick_rate"]; }
+    // Parte final da espera por um tick feita em spin (precisão vs. CPU)
+    uint32_t getTickSpinMicros() const { return valueOr<uint32_t>("server", "tick_spin_us", 200); }
+    
+    // Network config
+    bool isNetworkIOThreadEnabled() const { return valueOr("network", "io_thread", false); }
+    size_t getNetworkQueueCapacity() const { return valueOr<size_t>("network", "queue_capacity", 16384); }
+    size_t getNetworkHostCount() const { return valueOr<size_t>("network", "hosts", 1); }
+    bool isNetworkReusePortEnabled() const { return valueOr("network", "reuse_port", true); }
+    // Envelope BATCH na saída; só para clientes que sabem abri-lo
+    bool isNetworkBatchingEnabled() const { return valueOr("network", "batching", false); }
+    size_t getNetworkBatchSize() const { return valueOr<size_t>("network", "batch_size", 1200); }
+    size_t getNetworkPacketPoolSize() const { return valueOr<size_t>("network", "packet_pool_size", 4096); }
+    // Classe de entrega por tipo de pacote, ex.: {"CHAT_MESSAGE": "UNSEQUENCED"}
+    std::map<std::string, std::string> getNetworkChannels() const {
+        return valueOr<std::map<std::string, std::string>>("network", "channels", {});
+    }
+    // "ZSTD" para todos os hosts ou ["ZSTD", "NONE", ...] um por host
+    std::vector<std::string> getNetworkCompression() const {
+        if (!config_.is_object() || !config_.contains("network") || !config_["network"].contains("compression")) {
+            return {};
+        }
+        const auto& value = config_["network"]["compression"];
+        if (value.is_string()) {
+            return {value.get<std::string>()};
+        }
+        return value.get<std::vector<std::string>>();
+    }
+    int getNetworkCompressionLevel() const { return valueOr("network", "compression_level", 3); }
+    std::string getNetworkCompressionDictionary() const {
+        return valueOr<std::string>("network", "compression_dictionary", "");
+    }
+    // Arquivo de captura dos pacotes recebidos ("" = desligado)
+    std::string getNetworkCaptureFile() const { return valueOr<std::string>("network", "capture_file", ""); }
+    // Responde a pedidos SERVER_STATS (usado pelo loadbot)
+    bool isStatsRequestEnabled() const { return valueOr("network", "stats_requests", false); }
+    // Taxa de replicação por peer em bytes/s (0 = sem limite, o padrão)
+    size_t getPeerBandwidth() const { return valueOr<size_t>("network", "peer_bandwidth", 0); }
     
     // Database config
     std::string getDatabaseConnectionString() const;
     int getDatabasePoolSize() const { return config_["database"]["pool_size"]; }
     
     // Game config
-    float getWorldSize() const { return config_["game"]["world_size"]; }
-    float getSpatialGridCellSize() const { return config_["game"]["spatial_grid_cell_size"]; }
+    // Lado do mundo centrado na origem (0 = sem limite; DENSE exige)
+    float getWorldSize() const { return valueOr("game", "world_size", 0.0f); }
+    float getSpatialGridCellSize() const { return valueOr("game", "spatial_grid_cell_size", 50.0f); }
+    // "HASH", "DENSE" (grade plana limitada por world_size) ou "QUADTREE"
+    // (loose quadtree para jogadores concentrados)
+    std::string getSpatialBackend() const { return valueOr<std::string>("game", "spatial_backend", "HASH"); }
+    // Threads extras para os vizinhos em lote de cada tick (0 = só a do tick)
+    size_t getNeighborThreads() const { return valueOr<size_t>("game", "neighbor_threads", 0); }
+    float getViewRadius() const { return valueOr("game", "view_radius", 150.0f); }
     
     // Security config
     int getRateLimitPerSecond() const { return config_["security"]["rate_limit_per_second"]; }
@@ -40,5 +86,14 @@ private:
     Config(const Config&) = delete;
     Config& operator=(const Config&) = delete;
     
+    // Lê uma chave opcional, retornando o default se a seção ou chave não existir
+    template<typename T>
+    T valueOr(const char* section, const char* key, T fallback) const {
+        if (!config_.is_object() || !config_.contains(section)) {
+            return fallback;
+        }
+        return config_[section].value(key, fallback);
+    }
+    
     nlohmann::json config_;
 };
\ No newline at end of file
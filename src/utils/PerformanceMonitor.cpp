@@ -20,11 +20,22 @@ PerformanceMonitor::PerformanceMonitor()
     metrics_.max_frame_time_ms = 0.0;
     metrics_.total_frames = 0;
     metrics_.uptime_seconds = 0.0;
+    metrics_.avg_tick_jitter_us = 0.0;
+    metrics_.max_tick_jitter_us = 0.0;
+    metrics_.avg_wake_latency_us = 0.0;
+    metrics_.max_wake_latency_us = 0.0;
+    metrics_.traffic_wakeups = 0;
     metrics_.connected_players = 0;
     metrics_.total_packets_sent = 0;
     metrics_.total_packets_received = 0;
     metrics_.database_avg_query_time_ms = 0.0;
     metrics_.database_queries_executed = 0;
+    metrics_.compression_bytes_in = 0;
+    metrics_.compression_bytes_out = 0;
+    metrics_.compression_time_ms = 0.0;
+    metrics_.decompression_bytes_in = 0;
+    metrics_.decompression_bytes_out = 0;
+    metrics_.decompression_time_ms = 0.0;
 }
 
 void PerformanceMonitor::startFrame() {
@@ -56,14 +67,45 @@ void PerformanceMonitor::endFrame() {
     metrics_.uptime_seconds = uptime.count();
 }
 
-void PerformanceMonitor::recordPacketSent() {
+void PerformanceMonitor::recordTickJitter(double jitter_us) {
     std::lock_guard<std::mutex> lock(mutex_);
-    metrics_.total_packets_sent++;
+    tick_jitter_sum_ += jitter_us;
+    tick_jitter_count_++;
+    metrics_.avg_tick_jitter_us = tick_jitter_sum_ / tick_jitter_count_;
+    metrics_.max_tick_jitter_us = std::max(metrics_.max_tick_jitter_us, jitter_us);
 }
 
-void PerformanceMonitor::recordPacketReceived() {
+void PerformanceMonitor::recordWakeLatency(double latency_us) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    wake_latency_sum_ += latency_us;
+    wake_latency_count_++;
+    metrics_.avg_wake_latency_us = wake_latency_sum_ / wake_latency_count_;
+    metrics_.max_wake_latency_us = std::max(metrics_.max_wake_latency_us, latency_us);
+}
+
+void PerformanceMonitor::recordTrafficWakeup() {
     std::lock_guard<std::mutex> lock(mutex_);
-    metrics_.total_packets_received++;
+    metrics_.traffic_wakeups++;
+}
+
+void PerformanceMonitor::recordPacketSent(size_t count) {
+    packets_sent_.fetch_add(count, std::memory_order_relaxed);
+}
+
+void PerformanceMonitor::recordPacketReceived() {
+    packets_received_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PerformanceMonitor::recordCompression(size_t bytes_in, size_t bytes_out, uint64_t duration_ns) {
+    compression_in_.fetch_add(bytes_in, std::memory_order_relaxed);
+    compression_out_.fetch_add(bytes_out, std::memory_order_relaxed);
+    compression_ns_.fetch_add(duration_ns, std::memory_order_relaxed);
+}
+
+void PerformanceMonitor::recordDecompression(size_t bytes_in, size_t bytes_out, uint64_t duration_ns) {
+    decompression_in_.fetch_add(bytes_in, std::memory_order_relaxed);
+    decompression_out_.fetch_add(bytes_out, std::memory_order_relaxed);
+    decompression_ns_.fetch_add(duration_ns, std::memory_order_relaxed);
 }
 
 void PerformanceMonitor::recordDatabaseQuery(double duration_ms) {
@@ -76,10 +118,20 @@ void PerformanceMonitor::recordDatabaseQuery(double duration_ms) {
 
 PerformanceMetrics PerformanceMonitor::getMetrics() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return metrics_;
+    PerformanceMetrics metrics = metrics_;
+    metrics.total_packets_sent = packets_sent_.load(std::memory_order_relaxed);
+    metrics.total_packets_received = packets_received_.load(std::memory_order_relaxed);
+    metrics.compression_bytes_in = compression_in_.load(std::memory_order_relaxed);
+    metrics.compression_bytes_out = compression_out_.load(std::memory_order_relaxed);
+    metrics.compression_time_ms = compression_ns_.load(std::memory_order_relaxed) / 1e6;
+    metrics.decompression_bytes_in = decompression_in_.load(std::memory_order_relaxed);
+    metrics.decompression_bytes_out = decompression_out_.load(std::memory_order_relaxed);
+    metrics.decompression_time_ms = decompression_ns_.load(std::memory_order_relaxed) / 1e6;
+    return metrics;
 }
 
 void PerformanceMonitor::printReport() const {
+    PerformanceMetrics metrics = getMetrics();
     std::lock_guard<std::mutex> lock(mutex_);
     
     std::stringstream ss;
@@ -93,10 +145,28 @@ void PerformanceMonitor::printReport() const {
     ss << "Max Frame Time: " << metrics_.max_frame_time_ms << " ms\n";
     ss << "Avg FPS: " << std::setprecision(1) 
        << (1000.0 / metrics_.avg_frame_time_ms) << "\n";
+    if (metrics_.avg_tick_jitter_us > 0.0) {
+        ss << "Tick Jitter: avg " << std::setprecision(1) << metrics_.avg_tick_jitter_us
+           << " us, max " << metrics_.max_tick_jitter_us << " us\n";
+        ss << "Wake Latency: avg " << metrics_.avg_wake_latency_us
+           << " us, max " << metrics_.max_wake_latency_us << " us\n";
+        ss << "Traffic Wakeups: " << metrics_.traffic_wakeups << "\n";
+    }
     ss << "\nNetwork:\n";
     ss << "  Connected Players: " << metrics_.connected_players << "\n";
-    ss << "  Packets Sent: " << metrics_.total_packets_sent << "\n";
-    ss << "  Packets Received: " << metrics_.total_packets_received << "\n";
+    ss << "  Packets Sent: " << metrics.total_packets_sent << "\n";
+    ss << "  Packets Received: " << metrics.total_packets_received << "\n";
+    if (metrics.compression_bytes_in > 0) {
+        ss << "  Compression Ratio: " << std::setprecision(3)
+           << static_cast<double>(metrics.compression_bytes_out) / metrics.compression_bytes_in
+           << " (" << metrics.compression_bytes_in << " -> " << metrics.compression_bytes_out << " bytes, "
+           << metrics.compression_time_ms << " ms CPU)\n";
+    }
+    if (metrics.decompression_bytes_in > 0) {
+        ss << "  Decompressed: " << metrics.decompression_bytes_in << " -> "
+           << metrics.decompression_bytes_out << " bytes (" << std::setprecision(3)
+           << metrics.decompression_time_ms << " ms CPU)\n";
+    }
     ss << "\nDatabase:\n";
     ss << "  Queries Executed: " << metrics_.database_queries_executed << "\n";
     ss << "  Avg Query Time: " << std::setprecision(3) 
@@ -112,6 +182,18 @@ void PerformanceMonitor::reset() {
     start_time_ = std::chrono::steady_clock::now();
     frame_time_sum_ = 0.0;
     frame_count_ = 0;
+    tick_jitter_sum_ = 0.0;
+    tick_jitter_count_ = 0;
+    wake_latency_sum_ = 0.0;
+    wake_latency_count_ = 0;
     
     metrics_ = PerformanceMetrics{};
+    packets_sent_ = 0;
+    packets_received_ = 0;
+    compression_in_ = 0;
+    compression_out_ = 0;
+    compression_ns_ = 0;
+    decompression_in_ = 0;
+    decompression_out_ = 0;
+    decompression_ns_ = 0;
 }
\ No newline at end of file
@@ -1,7 +1,9 @@
 // include/utils/PerformanceMonitor.h
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <mutex>
@@ -12,10 +14,26 @@ struct PerformanceMetrics {
     double max_frame_time_ms;
     size_t total_frames;
     double uptime_seconds;
+
+    // Agendamento de ticks (TickScheduler): atraso do início do tick em
+    // relação ao deadline e atraso do kernel ao acordar do timer
+    double avg_tick_jitter_us;
+    double max_tick_jitter_us;
+    double avg_wake_latency_us;
+    double max_wake_latency_us;
+    size_t traffic_wakeups;     // esperas interrompidas por tráfego
     
     size_t connected_players;
     size_t total_packets_sent;
     size_t total_packets_received;
+
+    // Compressão de datagramas (bytes antes/depois e tempo de CPU)
+    uint64_t compression_bytes_in;
+    uint64_t compression_bytes_out;
+    double compression_time_ms;
+    uint64_t decompression_bytes_in;
+    uint64_t decompression_bytes_out;
+    double decompression_time_ms;
     
     double database_avg_query_time_ms;
     size_t database_queries_executed;
@@ -28,9 +46,19 @@ public:
     void startFrame();
     void endFrame();
     
-    void recordPacketSent();
+    void recordTickJitter(double jitter_us);
+    void recordWakeLatency(double latency_us);
+    void recordTrafficWakeup();
+
+    // Mensagens enviadas: o NetworkManager conta uma por destinatário.
+    // Sem lock: broadcasts chamam uma vez por peer.
+    void recordPacketSent(size_t count = 1);
     void recordPacketReceived();
     
+    // Chamados pelas threads de I/O a cada datagrama; sem lock
+    void recordCompression(size_t bytes_in, size_t bytes_out, uint64_t duration_ns);
+    void recordDecompression(size_t bytes_in, size_t bytes_out, uint64_t duration_ns);
+
     void recordDatabaseQuery(double duration_ms);
     
     void setConnectedPlayers(size_t count) { metrics_.connected_players = count; }
@@ -54,4 +82,18 @@ private:
     
     double frame_time_sum_;
     size_t frame_count_;
+
+    double tick_jitter_sum_ = 0.0;
+    size_t tick_jitter_count_ = 0;
+    double wake_latency_sum_ = 0.0;
+    size_t wake_latency_count_ = 0;
+
+    std::atomic<uint64_t> packets_sent_{0};
+    std::atomic<uint64_t> packets_received_{0};
+    std::atomic<uint64_t> compression_in_{0};
+    std::atomic<uint64_t> compression_out_{0};
+    std::atomic<uint64_t> compression_ns_{0};
+    std::atomic<uint64_t> decompression_in_{0};
+    std::atomic<uint64_t> decompression_out_{0};
+    std::atomic<uint64_t> decompression_ns_{0};
 };
\ No newline at end of file
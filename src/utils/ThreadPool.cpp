@@ -0,0 +1,77 @@
+// src/utils/ThreadPool.cpp
+#include "utils/ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t worker_count) {
+    workers_.reserve(worker_count);
+    for (size_t i = 0; i < worker_count; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const RangeFunction& body, size_t grain) {
+    grain = std::max<size_t>(grain, 1);
+    if (workers_.empty() || count <= grain) {
+        if (count > 0) {
+            body(0, count);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard lock(mutex_);
+        body_ = &body;
+        count_ = count;
+        grain_ = grain;
+        next_.store(0, std::memory_order_relaxed);
+        active_ = workers_.size();
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    runRanges();
+
+    std::unique_lock lock(mutex_);
+    done_.wait(lock, [this] { return active_ == 0; });
+    body_ = nullptr;
+}
+
+void ThreadPool::runRanges() {
+    size_t begin;
+    while ((begin = next_.fetch_add(grain_, std::memory_order_relaxed)) < count_) {
+        (*body_)(begin, std::min(begin + grain_, count_));
+    }
+}
+
+void ThreadPool::workerLoop() {
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock lock(mutex_);
+            wake_.wait(lock, [this, seen] { return stopping_ || generation_ != seen; });
+            if (stopping_) {
+                return;
+            }
+            seen = generation_;
+        }
+
+        runRanges();
+
+        std::lock_guard lock(mutex_);
+        if (--active_ == 0) {
+            done_.notify_one();
+        }
+    }
+}
@@ -0,0 +1,51 @@
+// include/utils/ThreadPool.h
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool fixo para trabalho fork-join dentro do tick. parallelFor divide
+// [0, count) em blocos de 'grain' itens, a thread que chama também
+// trabalha e só retorna quando todos os blocos terminaram. Sem workers,
+// tudo roda na própria chamadora.
+//
+// Um parallelFor por vez (em geral a thread do tick); o corpo não deve
+// lançar exceções.
+class ThreadPool {
+public:
+    using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+    explicit ThreadPool(size_t worker_count);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void parallelFor(size_t count, const RangeFunction& body, size_t grain = 1);
+
+    size_t getWorkerCount() const { return workers_.size(); }
+
+private:
+    void workerLoop();
+    void runRanges();
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+
+    // Trabalho atual, publicado sob mutex_ junto com generation_
+    const RangeFunction* body_ = nullptr;
+    size_t count_ = 0;
+    size_t grain_ = 1;
+    std::atomic<size_t> next_{0};
+    size_t active_ = 0;            // workers ainda no trabalho atual
+    uint64_t generation_ = 0;
+    bool stopping_ = false;
+};
@@ -0,0 +1,221 @@
+// tools/bench/spatial_bench.cpp
+// Compara os backends do SpatialGrid (HASH x DENSE x QUADTREE) com os
+// mesmos jogadores: inserção, um tick de movimento, queryRadiusInto
+// (exata, com buffer reaproveitado) e queryArea (células inteiras), com
+// jogadores espalhados e concentrados em cidades, em raio curto e largo.
+// Depois compara uma query por jogador com os vizinhos em lote, com e
+// sem pool.
+#include "server/SpatialGrid.h"
+#include "utils/Logger.h"
+#include "utils/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+struct Position {
+    float x, z;
+};
+
+struct Result {
+    double insert_ms;
+    double update_ms;
+    double radius_ns;
+    double area_ns;
+    uint64_t radius_hits;
+    uint64_t area_hits;
+};
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedNs(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+// Ids como handles de peer: slot i, geração 1
+static uint32_t idOf(size_t i) {
+    return static_cast<uint32_t>((1u << 20) | i);
+}
+
+static Result run(SpatialGrid& grid, const std::vector<Position>& spawn, const std::vector<Position>& moved,
+                  const std::vector<Position>& probes, float radius, int rounds) {
+    Result result{};
+
+    auto start = Clock::now();
+    for (size_t i = 0; i < spawn.size(); ++i)
+        grid.insertPlayer(idOf(i), spawn[i].x, spawn[i].z);
+    result.insert_ms = elapsedNs(start) / 1e6;
+
+    // Tick: todos atualizados, a maioria sem trocar de célula
+    start = Clock::now();
+    for (size_t i = 0; i < moved.size(); ++i)
+        grid.updatePlayer(idOf(i), moved[i].x, moved[i].z);
+    result.update_ms = elapsedNs(start) / 1e6;
+
+    // Primeira query paga o rebuild do DENSE; mede só o estado estável
+    std::vector<uint32_t> nearby;
+    grid.queryRadiusInto(0.0f, 0.0f, radius, nearby);
+
+    start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (const Position& p : probes)
+            result.radius_hits += grid.queryRadiusInto(p.x, p.z, radius, nearby);
+    }
+    result.radius_ns = elapsedNs(start) / (static_cast<double>(rounds) * probes.size());
+
+    start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (const Position& p : probes)
+            result.area_hits += grid.queryArea(p.x - radius, p.z - radius, p.x + radius, p.z + radius).size();
+    }
+    result.area_ns = elapsedNs(start) / (static_cast<double>(rounds) * probes.size());
+
+    return result;
+}
+
+struct Scenario {
+    const char* name;
+    std::vector<Position> spawn;
+    std::vector<Position> moved;
+    std::vector<Position> probes;
+};
+
+// Roda os três backends num cenário; falha se os raios divergirem
+static int report(const Scenario& scenario, float cell_size, float world_size, float radius, int rounds) {
+    HashSpatialGrid hash_grid(cell_size);
+    DenseSpatialGrid dense_grid(cell_size, world_size);
+    QuadtreeSpatialGrid quadtree_grid(cell_size, world_size);
+
+    Result results[] = {
+        run(hash_grid, scenario.spawn, scenario.moved, scenario.probes, radius, rounds),
+        run(dense_grid, scenario.spawn, scenario.moved, scenario.probes, radius, rounds),
+        run(quadtree_grid, scenario.spawn, scenario.moved, scenario.probes, radius, rounds),
+    };
+    const char* names[] = {"HASH", "DENSE", "QUADTREE"};
+
+    std::printf("%s, radius %.0f (quadtree nodes: %zu):\n", scenario.name, radius, quadtree_grid.getNodeCount());
+    std::printf("  %-8s %12s %12s %16s %16s %12s\n", "backend", "insert ms", "update ms", "radius ns/query",
+                "area ns/query", "area ids");
+    for (size_t i = 0; i < 3; ++i) {
+        std::printf("  %-8s %12.2f %12.2f %16.1f %16.1f %12llu\n", names[i], results[i].insert_ms,
+                    results[i].update_ms, results[i].radius_ns, results[i].area_ns,
+                    static_cast<unsigned long long>(results[i].area_hits));
+    }
+    // O raio é exato em todos; a área retorna células (ou nós) inteiras
+    std::printf("  radius hits: %llu\n", static_cast<unsigned long long>(results[0].radius_hits));
+    return results[0].radius_hits == results[1].radius_hits && results[0].radius_hits == results[2].radius_hits
+               ? 0 : 1;
+}
+
+// Vizinhos de todos: uma queryRadiusInto por jogador x computeNeighbors
+static int runNeighbors(SpatialGrid& grid, const std::vector<Position>& positions, float radius,
+                        size_t threads, int rounds) {
+    // Mesmo resultado montado com uma query por jogador (sem o próprio)
+    std::vector<uint32_t> nearby, offsets, neighbors;
+    auto start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        offsets.assign(1, 0);
+        neighbors.clear();
+        for (size_t i = 0; i < positions.size(); ++i) {
+            grid.queryRadiusInto(positions[i].x, positions[i].z, radius, nearby);
+            for (uint32_t id : nearby) {
+                if (id != idOf(i)) neighbors.push_back(id);
+            }
+            offsets.push_back(static_cast<uint32_t>(neighbors.size()));
+        }
+    }
+    double per_query_ms = elapsedNs(start) / 1e6 / rounds;
+    uint64_t per_query_pairs = neighbors.size();
+
+    NeighborLists lists;
+    start = Clock::now();
+    for (int r = 0; r < rounds; ++r)
+        grid.computeNeighbors(radius, lists);
+    double serial_ms = elapsedNs(start) / 1e6 / rounds;
+    uint64_t serial_pairs = lists.neighbors.size();
+
+    ThreadPool pool(threads);
+    start = Clock::now();
+    for (int r = 0; r < rounds; ++r)
+        grid.computeNeighbors(radius, lists, &pool);
+    double pooled_ms = elapsedNs(start) / 1e6 / rounds;
+
+    std::printf("neighbors of all players (radius %.0f):\n", radius);
+    std::printf("  queryRadiusInto per player: %8.2f ms\n", per_query_ms);
+    std::printf("  computeNeighbors:           %8.2f ms (%.2fx)\n", serial_ms, per_query_ms / serial_ms);
+    std::printf("  computeNeighbors, %zu+1 threads: %5.2f ms (%.2fx)\n", threads, pooled_ms,
+                per_query_ms / pooled_ms);
+    std::printf("  neighbor entries: %llu %llu %zu\n", static_cast<unsigned long long>(per_query_pairs),
+                static_cast<unsigned long long>(serial_pairs), lists.neighbors.size());
+    return per_query_pairs == serial_pairs && serial_pairs == lists.neighbors.size() ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t players = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    const float world_size = argc > 2 ? std::strtof(argv[2], nullptr) : 4000.0f;
+    const size_t threads = argc > 3 ? std::strtoul(argv[3], nullptr, 10)
+                                    : std::max(1u, std::thread::hardware_concurrency()) - 1;
+    const float cell_size = 50.0f;
+    const float radius = 150.0f;
+    const float wide_radius = 600.0f;
+    const int rounds = 20;
+
+    Logger::setLevel(Logger::Level::WARNING);
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> coord(-0.5f * world_size, 0.5f * world_size);
+    std::uniform_real_distribution<float> step(-2.0f, 2.0f);
+
+    // Espalhados: posições e queries uniformes no mundo
+    Scenario uniform{"uniform", std::vector<Position>(players), std::vector<Position>(players),
+                     std::vector<Position>(1000)};
+    for (size_t i = 0; i < players; ++i) {
+        uniform.spawn[i] = {coord(rng), coord(rng)};
+        uniform.moved[i] = {uniform.spawn[i].x + step(rng), uniform.spawn[i].z + step(rng)};
+    }
+    for (Position& p : uniform.probes)
+        p = {coord(rng), coord(rng)};
+
+    // Concentrados: 90% em 8 cidades (gaussianas de desvio 60), o resto
+    // espalhado; as queries partem dos próprios jogadores
+    Scenario clustered{"clustered", std::vector<Position>(players), std::vector<Position>(players),
+                       std::vector<Position>(1000)};
+    std::vector<Position> cities(8);
+    for (Position& city : cities)
+        city = {0.8f * coord(rng), 0.8f * coord(rng)};
+    std::normal_distribution<float> spread(0.0f, 60.0f);
+    std::uniform_int_distribution<size_t> pick_city(0, cities.size() - 1);
+    std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+    for (size_t i = 0; i < players; ++i) {
+        if (chance(rng) < 0.9f) {
+            const Position& city = cities[pick_city(rng)];
+            clustered.spawn[i] = {city.x + spread(rng), city.z + spread(rng)};
+        } else {
+            clustered.spawn[i] = {coord(rng), coord(rng)};
+        }
+        clustered.moved[i] = {clustered.spawn[i].x + step(rng), clustered.spawn[i].z + step(rng)};
+    }
+    std::uniform_int_distribution<size_t> pick_player(0, players - 1);
+    for (Position& p : clustered.probes)
+        p = clustered.moved[pick_player(rng)];
+
+    std::printf("players: %zu, world: %.0f, cell: %.0f, dense cells: %zu\n", players, world_size, cell_size,
+                DenseSpatialGrid(cell_size, world_size).getCellCount());
+
+    int failed = 0;
+    for (const Scenario* scenario : {&uniform, &clustered}) {
+        failed |= report(*scenario, cell_size, world_size, radius, rounds);
+        failed |= report(*scenario, cell_size, world_size, wide_radius, rounds / 4);
+    }
+    if (failed) {
+        return 1;
+    }
+
+    DenseSpatialGrid dense_grid(cell_size, world_size);
+    for (size_t i = 0; i < players; ++i)
+        dense_grid.insertPlayer(idOf(i), uniform.moved[i].x, uniform.moved[i].z);
+    return runNeighbors(dense_grid, uniform.moved, radius, threads, 5);
+}
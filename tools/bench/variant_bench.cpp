@@ -0,0 +1,189 @@
+// tools/bench/variant_bench.cpp
+// Compara o Variant antigo (std::string/vector/unordered_map por valor)
+// com o Variant compacto e com o RPC tipado (decodificado direto do
+// wire) processando o mesmo pacote de RPC.
+#include "server/RPCRegistry.h"
+#include "utils/Logger.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ========== Variant antigo (cópia do formato anterior) ==========
+struct LegacyVariant {
+    Variant::Type type = Variant::NIL;
+    bool b = false;
+    int64_t i = 0;
+    double f = 0.0;
+    std::string s;
+    Vector3 v3{};
+    std::vector<LegacyVariant> arr;
+    std::unordered_map<std::string, LegacyVariant> dict;
+};
+
+static uint32_t legacyReadU32(const uint8_t*& ptr, const uint8_t* end) {
+    if (end - ptr < 4) throw std::runtime_error("EOF while reading u32");
+    uint32_t v;
+    std::memcpy(&v, ptr, 4);
+    ptr += 4;
+    return v;
+}
+
+static std::string legacyReadString(const uint8_t*& ptr, const uint8_t* end) {
+    uint32_t len = legacyReadU32(ptr, end);
+    if (len > static_cast<uint32_t>(end - ptr)) throw std::runtime_error("EOF while reading string data");
+    std::string result(reinterpret_cast<const char*>(ptr), len);
+    ptr += len;
+    return result;
+}
+
+static LegacyVariant legacyReadVariant(const uint8_t*& ptr, const uint8_t* end) {
+    if (ptr >= end) throw std::runtime_error("EOF while reading variant type");
+    LegacyVariant v;
+    v.type = static_cast<Variant::Type>(*ptr++);
+    switch (v.type) {
+        case Variant::BOOL:
+            v.b = (*ptr++ != 0);
+            break;
+        case Variant::INT:
+            std::memcpy(&v.i, ptr, 8);
+            ptr += 8;
+            break;
+        case Variant::FLOAT:
+            std::memcpy(&v.f, ptr, 8);
+            ptr += 8;
+            break;
+        case Variant::STRING:
+            v.s = legacyReadString(ptr, end);
+            break;
+        case Variant::VECTOR3: {
+            double x, y, z;
+            std::memcpy(&x, ptr, 8); ptr += 8;
+            std::memcpy(&y, ptr, 8); ptr += 8;
+            std::memcpy(&z, ptr, 8); ptr += 8;
+            v.v3 = Vector3{static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)};
+            break;
+        }
+        case Variant::ARRAY: {
+            uint32_t count = legacyReadU32(ptr, end);
+            v.arr.reserve(count);
+            for (uint32_t i = 0; i < count; ++i)
+                v.arr.push_back(legacyReadVariant(ptr, end));
+            break;
+        }
+        case Variant::DICTIONARY: {
+            uint32_t count = legacyReadU32(ptr, end);
+            for (uint32_t i = 0; i < count; ++i) {
+                std::string key = legacyReadString(ptr, end);
+                v.dict.emplace(std::move(key), legacyReadVariant(ptr, end));
+            }
+            break;
+        }
+        default:
+            v.type = Variant::NIL;
+            break;
+    }
+    return v;
+}
+
+// ========== Pacote de teste ==========
+// Mistura típica: posição, direção, nome curto, texto longo, lista de
+// ids e um dicionário pequeno
+static std::vector<Variant> makeArgs(Arena& arena) {
+    static Variant ids[4] = {Variant(int64_t{11}), Variant(int64_t{12}), Variant(int64_t{13}), Variant(int64_t{14})};
+    static VariantPair opts[2];
+    opts[0] = VariantPair{Variant::string("speed", arena), Variant(4.5)};
+    opts[1] = VariantPair{Variant::string("crouch", arena), Variant(false)};
+
+    return {
+        Variant(Vector3{10.0f, 0.0f, -3.5f}),
+        Variant(0.75),
+        Variant::string("player_42", arena),
+        Variant::string("a chat message that does not fit inline", arena),
+        Variant::array(ids),
+        Variant::dictionary(opts),
+    };
+}
+
+static std::vector<uint8_t> makePacket(uint16_t method_id, const std::vector<Variant>& args) {
+    // Mesmo formato comprimido que o servidor envia (node 1)
+    std::vector<uint8_t> packet;
+    BinaryWriter writer(packet);
+    writer.writeU8(rpc_wire::kRemoteCall);
+    rpc_wire::writeCall(writer, 1, method_id, args);
+    return packet;
+}
+
+int main(int argc, char* argv[]) {
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+    Logger::setLevel(Logger::Level::WARNING);
+
+    RPCHandler handler;
+    uint64_t checksum = 0;
+    handler.registerRPCCallbackWithId(1, "bench", [&checksum](uint32_t, const std::vector<Variant>& args) {
+        checksum += args.size() + args[2].asString().size();
+    });
+
+    RPCRegistry registry(handler);
+    uint64_t typed_checksum = 0;
+    registry.registerRPCTypedWithId<Vector3, double, std::string_view, std::string_view,
+                                    std::span<const Variant>, std::span<const VariantPair>>(
+        2, "bench_typed",
+        std::function<void(uint32_t, Vector3, double, std::string_view, std::string_view,
+                           std::span<const Variant>, std::span<const VariantPair>)>(
+            [&typed_checksum](uint32_t, Vector3, double, std::string_view name, std::string_view,
+                              std::span<const Variant>, std::span<const VariantPair>) {
+                typed_checksum += 6 + name.size();
+            }));
+
+    Arena arena;
+    std::vector<uint8_t> packet = makePacket(1, makeArgs(arena));
+    std::vector<uint8_t> typed_packet = makePacket(2, makeArgs(arena));
+    // [0x20][meta][node u8][método u8][argc][argumentos]
+    const uint8_t* args_begin = packet.data() + 5;
+    const uint8_t* args_end = packet.data() + packet.size();
+    const size_t arg_count = packet[4];
+
+    using Clock = std::chrono::steady_clock;
+
+    // Decodificação antiga: vetor novo de LegacyVariant por pacote
+    uint64_t legacy_checksum = 0;
+    auto start = Clock::now();
+    for (int n = 0; n < iterations; ++n) {
+        const uint8_t* ptr = args_begin;
+        std::vector<LegacyVariant> args;
+        args.reserve(arg_count);
+        for (size_t i = 0; i < arg_count; ++i)
+            args.push_back(legacyReadVariant(ptr, args_end));
+        legacy_checksum += args.size() + args[2].s.size();
+    }
+    double legacy_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations;
+
+    // Caminho real: processGodotPacket com Variant compacto e arena
+    start = Clock::now();
+    for (int n = 0; n < iterations; ++n) {
+        handler.processGodotPacket(1, packet);
+    }
+    double compact_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations;
+
+    // RPC tipado: sem vetor de Variants
+    start = Clock::now();
+    for (int n = 0; n < iterations; ++n) {
+        handler.processGodotPacket(1, typed_packet);
+    }
+    double typed_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations;
+
+    std::printf("packet: %zu bytes, %zu args, %d iterations\n", packet.size(), arg_count, iterations);
+    std::printf("sizeof(LegacyVariant) = %zu, sizeof(Variant) = %zu\n", sizeof(LegacyVariant), sizeof(Variant));
+    std::printf("legacy decode:          %8.1f ns/packet\n", legacy_ns);
+    std::printf("compact dispatch:       %8.1f ns/packet (%.2fx)\n", compact_ns, legacy_ns / compact_ns);
+    std::printf("typed dispatch:         %8.1f ns/packet (%.2fx)\n", typed_ns, legacy_ns / typed_ns);
+    std::printf("checksums: %llu %llu %llu\n", static_cast<unsigned long long>(legacy_checksum),
+                static_cast<unsigned long long>(checksum), static_cast<unsigned long long>(typed_checksum));
+    return legacy_checksum == checksum && checksum == typed_checksum ? 0 : 1;
+}
@@ -0,0 +1,374 @@
+// tools/loadbot/LoadBot.cpp
+#include "LoadBot.h"
+#include "Scenario.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+LoadBot::LoadBot(const LoadBotOptions& options) : options_(options) {}
+
+LoadBot::~LoadBot() {
+    for (Bot& bot : bots_) {
+        if (bot.peer) {
+            enet_peer_disconnect_now(bot.peer, 0);
+        }
+    }
+    for (ENetHost* host : hosts_) {
+        enet_host_destroy(host);
+    }
+}
+
+bool LoadBot::initialize() {
+    if (enet_address_set_host(&server_address_, options_.host.c_str()) != 0) {
+        std::cerr << "Invalid server address: " << options_.host << "\n";
+        return false;
+    }
+    server_address_.port = options_.port;
+
+    // Mesmo compressor do servidor; o modo precisa bater com network.compression
+    CompressionDictionary dictionary;
+    if (!options_.compression_dictionary.empty()) {
+        std::ifstream file(options_.compression_dictionary, std::ios::binary);
+        if (!file) {
+            std::cerr << "Failed to open compression dictionary: " << options_.compression_dictionary << "\n";
+            return false;
+        }
+        dictionary = std::make_shared<std::vector<uint8_t>>(
+            std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    size_t host_count = (options_.clients + kBotsPerHost - 1) / kBotsPerHost;
+    for (size_t i = 0; i < host_count; ++i) {
+        size_t peers = std::min(kBotsPerHost, options_.clients - i * kBotsPerHost);
+        ENetHost* host = enet_host_create(nullptr, peers, kChannelCount, 0, 0);
+        if (!host) {
+            std::cerr << "Failed to create client host " << i << "\n";
+            return false;
+        }
+        hosts_.push_back(host);
+        if (!installCompressor(host, options_.compression, options_.compression_level, dictionary)) {
+            std::cerr << "Failed to install compressor on client host " << i << "\n";
+            return false;
+        }
+    }
+
+    bots_.resize(options_.clients);
+    for (size_t i = 0; i < bots_.size(); ++i) {
+        bots_[i].index = static_cast<uint32_t>(i);
+    }
+
+    scenario_ = std::make_unique<Scenario>(*this);
+    return scenario_->load(options_.script);
+}
+
+// =============================================================
+// Envio
+// =============================================================
+void LoadBot::send(Bot& bot, uint8_t channel, uint32_t flags) {
+    send(bot, scratch_, channel, flags);
+}
+
+void LoadBot::send(Bot& bot, const std::vector<uint8_t>& data, uint8_t channel, uint32_t flags) {
+    if (!bot.connected) {
+        return;
+    }
+    ENetPacket* packet = enet_packet_create(data.data(), data.size(), flags);
+    if (enet_peer_send(bot.peer, channel, packet) != 0) {
+        enet_packet_destroy(packet);
+    }
+}
+
+void LoadBot::sendAuth(Bot& bot, std::string_view payload) {
+    protocol::encodeAuth(scratch_, payload);
+    send(bot, kReliableChannel, ENET_PACKET_FLAG_RELIABLE);
+}
+
+void LoadBot::sendMove(Bot& bot, const Vector3& position) {
+    bot.position = position;
+    protocol::encodePlayerMove(scratch_, position);
+    send(bot, kSequencedChannel, 0);
+}
+
+void LoadBot::sendChat(Bot& bot, std::string_view text) {
+    protocol::encodeChat(scratch_, text);
+    send(bot, kReliableChannel, ENET_PACKET_FLAG_RELIABLE);
+}
+
+void LoadBot::sendRPC(Bot& bot, uint32_t node_id, uint16_t method_id, const std::vector<Variant>& args) {
+    if (!protocol::encodeGodotRPC(scratch_, node_id, method_id, args)) {
+        std::cerr << "RPC " << method_id << " has too many args: " << args.size() << "\n";
+        return;
+    }
+    if (options_.batch_rpcs) {
+        protocol::appendToRPCBatch(bot.rpc_batch, scratch_);
+        return;
+    }
+    send(bot, kReliableChannel, ENET_PACKET_FLAG_RELIABLE);
+}
+
+void LoadBot::flushRPCs(Bot& bot) {
+    if (bot.rpc_batch.empty()) {
+        return;
+    }
+    send(bot, bot.rpc_batch, kReliableChannel, ENET_PACKET_FLAG_RELIABLE);
+    bot.rpc_batch.clear();
+}
+
+// =============================================================
+// Eventos
+// =============================================================
+void LoadBot::connectPending(float elapsed_seconds) {
+    // Rampa de conexões para não inundar o handshake do servidor
+    size_t target = std::min(bots_.size(), static_cast<size_t>(elapsed_seconds * options_.connect_rate) + 1);
+
+    for (; next_to_connect_ < target; ++next_to_connect_) {
+        Bot& bot = bots_[next_to_connect_];
+        ENetHost* host = hosts_[next_to_connect_ / kBotsPerHost];
+        bot.peer = enet_host_connect(host, &server_address_, kChannelCount, 0);
+        if (!bot.peer) {
+            std::cerr << "Failed to start connection for bot " << bot.index << "\n";
+            continue;
+        }
+        bot.peer->data = &bot;
+    }
+}
+
+void LoadBot::serviceHosts() {
+    ENetEvent event;
+    for (ENetHost* host : hosts_) {
+        while (enet_host_service(host, &event, 0) > 0) {
+            handleEvent(event);
+        }
+    }
+}
+
+void LoadBot::handleEvent(const ENetEvent& event) {
+    Bot* bot = static_cast<Bot*>(event.peer->data);
+    if (!bot) {
+        if (event.type == ENET_EVENT_TYPE_RECEIVE) {
+            enet_packet_destroy(event.packet);
+        }
+        return;
+    }
+
+    switch (event.type) {
+        case ENET_EVENT_TYPE_CONNECT:
+            bot->connected = true;
+            ++connected_count_;
+            scenario_->onConnect(*bot);
+            break;
+
+        case ENET_EVENT_TYPE_DISCONNECT:
+            if (bot->connected) {
+                --connected_count_;
+            }
+            ++disconnect_count_;
+            bot->connected = false;
+            bot->peer = nullptr;
+            break;
+
+        case ENET_EVENT_TYPE_RECEIVE:
+            ++interval_.packets_in;
+            ++total_.packets_in;
+            protocol::forEachMessage(event.packet->data, event.packet->dataLength,
+                [&](PacketType type, const uint8_t* payload, size_t size) {
+                    handleMessage(*bot, type, payload, size);
+                });
+            enet_packet_destroy(event.packet);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void LoadBot::handleMessage(Bot& bot, PacketType type, const uint8_t* payload, size_t size) {
+    switch (type) {
+        case PacketType::WORLD_STATE: {
+            // Confirma o snapshot como um cliente real, para o servidor
+            // seguir mandando deltas
+            if (size < sizeof(uint32_t)) {
+                break;
+            }
+            BinaryReader reader(payload, size);
+            uint32_t sequence = reader.readU32();
+            if (sequence > bot.last_snapshot) {
+                bot.last_snapshot = sequence;
+                protocol::encodeSnapshotAck(scratch_, sequence);
+                send(bot, kUnsequencedChannel, ENET_PACKET_FLAG_UNSEQUENCED);
+            }
+            break;
+        }
+
+        case PacketType::SERVER_STATS: {
+            protocol::ServerStats stats;
+            if (protocol::decodeServerStats(payload, size, stats)) {
+                recordServerStats(stats);
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+// =============================================================
+// Medição
+// =============================================================
+void LoadBot::tickBots(float delta_time) {
+    for (Bot& bot : bots_) {
+        if (bot.connected) {
+            scenario_->onTick(bot, delta_time);
+            flushRPCs(bot);
+        }
+    }
+}
+
+void LoadBot::sampleLinks() {
+    for (const Bot& bot : bots_) {
+        if (bot.connected) {
+            interval_.rtt_samples.push_back(bot.peer->roundTripTime);
+        }
+    }
+
+    // Bytes no fio (inclui cabeçalhos ENet); os totais são zerados a cada leitura
+    for (ENetHost* host : hosts_) {
+        interval_.bytes_in += host->totalReceivedData;
+        interval_.bytes_out += host->totalSentData;
+        host->totalReceivedData = 0;
+        host->totalSentData = 0;
+    }
+}
+
+void LoadBot::requestServerStats() {
+    // Basta um bot perguntar; o primeiro conectado serve
+    for (Bot& bot : bots_) {
+        if (bot.connected) {
+            protocol::encodeStatsRequest(scratch_);
+            send(bot, kReliableChannel, ENET_PACKET_FLAG_RELIABLE);
+            return;
+        }
+    }
+}
+
+void LoadBot::recordServerStats(const protocol::ServerStats& stats) {
+    for (IntervalStats* target : {&interval_, &total_}) {
+        if (!target->has_server_stats) {
+            target->server_begin = stats;
+            target->has_server_stats = true;
+        }
+        target->server_end = stats;
+    }
+}
+
+static uint32_t percentile(std::vector<uint32_t>& samples, double p) {
+    if (samples.empty()) {
+        return 0;
+    }
+    size_t k = std::min(samples.size() - 1, static_cast<size_t>(p * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + k, samples.end());
+    return samples[k];
+}
+
+void LoadBot::report(IntervalStats& stats, float elapsed, const char* label) {
+    // Tempo médio de tick do servidor no intervalo, a partir das médias acumuladas
+    double tick_ms = 0.0;
+    if (stats.has_server_stats && stats.server_end.total_frames > stats.server_begin.total_frames) {
+        double begin = static_cast<double>(stats.server_begin.avg_frame_ms) * stats.server_begin.total_frames;
+        double end = static_cast<double>(stats.server_end.avg_frame_ms) * stats.server_end.total_frames;
+        tick_ms = (end - begin) / (stats.server_end.total_frames - stats.server_begin.total_frames);
+    }
+
+    double per_client = connected_count_ > 0 && elapsed > 0.0f ? 1.0 / (connected_count_ * elapsed) : 0.0;
+
+    uint32_t p50 = percentile(stats.rtt_samples, 0.50);
+    uint32_t p95 = percentile(stats.rtt_samples, 0.95);
+    uint32_t p99 = percentile(stats.rtt_samples, 0.99);
+
+    char line[512];
+    std::snprintf(line, sizeof(line),
+                  "[%s] clients %zu/%zu (dropped %zu) | server tick avg %.3f ms max %.3f ms players %u | "
+                  "rtt p50 %u p95 %u p99 %u ms | per client in %.0f B/s out %.0f B/s",
+                  label, connected_count_, bots_.size(), disconnect_count_, tick_ms,
+                  stats.has_server_stats ? stats.server_end.max_frame_ms : 0.0f,
+                  stats.has_server_stats ? stats.server_end.connected_players : 0u,
+                  p50, p95, p99, stats.bytes_in * per_client, stats.bytes_out * per_client);
+    std::cout << line << std::endl;
+}
+
+// =============================================================
+// Loop principal
+// =============================================================
+void LoadBot::run(const std::atomic<bool>& running) {
+    const auto tick_interval = std::chrono::duration<float>(1.0f / options_.tick_rate);
+    const auto report_interval = std::chrono::duration<float>(options_.report_interval);
+    const auto sample_interval = std::chrono::seconds(1);
+
+    auto start = Clock::now();
+    auto last_tick = start;
+    auto last_sample = start;
+    auto last_report = start;
+
+    std::cout << "loadbot: " << bots_.size() << " clients -> " << options_.host << ":"
+              << options_.port << " (script " << options_.script << ")" << std::endl;
+
+    while (running.load()) {
+        auto now = Clock::now();
+        float elapsed = std::chrono::duration<float>(now - start).count();
+        if (options_.duration_seconds > 0.0f && elapsed >= options_.duration_seconds) {
+            break;
+        }
+
+        connectPending(elapsed);
+        serviceHosts();
+
+        if (now - last_tick >= tick_interval) {
+            tickBots(std::chrono::duration<float>(now - last_tick).count());
+            last_tick = now;
+        }
+
+        if (now - last_sample >= sample_interval) {
+            sampleLinks();
+            requestServerStats();
+            last_sample = now;
+        }
+
+        if (now - last_report >= report_interval) {
+            float interval = std::chrono::duration<float>(now - last_report).count();
+
+            total_.rtt_samples.insert(total_.rtt_samples.end(),
+                                      interval_.rtt_samples.begin(), interval_.rtt_samples.end());
+            total_.bytes_in += interval_.bytes_in;
+            total_.bytes_out += interval_.bytes_out;
+
+            char label[32];
+            std::snprintf(label, sizeof(label), "t=%.0fs", elapsed);
+            report(interval_, interval, label);
+
+            // O próximo intervalo começa onde este terminou
+            IntervalStats next;
+            next.has_server_stats = interval_.has_server_stats;
+            next.server_begin = interval_.server_end;
+            next.server_end = interval_.server_end;
+            interval_ = std::move(next);
+            last_report = now;
+        }
+
+        for (ENetHost* host : hosts_) {
+            enet_host_flush(host);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    sampleLinks();
+    total_.rtt_samples.insert(total_.rtt_samples.end(),
+                              interval_.rtt_samples.begin(), interval_.rtt_samples.end());
+    total_.bytes_in += interval_.bytes_in;
+    total_.bytes_out += interval_.bytes_out;
+
+    float elapsed = std::chrono::duration<float>(Clock::now() - start).count();
+    report(total_, elapsed, "total");
+}
@@ -0,0 +1,106 @@
+// tools/loadbot/LoadBot.h
+#pragma once
+
+#include <enet/enet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Protocol.h"
+#include "server/PacketCompressor.h"
+
+struct LoadBotOptions {
+    std::string host = "127.0.0.1";
+    uint16_t port = 7777;
+    size_t clients = 100;
+    size_t connect_rate = 200;          // conexões novas por segundo
+    float duration_seconds = 60.0f;     // 0 = até Ctrl+C
+    float tick_rate = 20.0f;            // chamadas de on_tick por segundo
+    float report_interval = 5.0f;       // segundos entre relatórios
+    std::string script = "scenarios/walk.lua";
+    bool batch_rpcs = false;            // RPCs do tick de um bot num frame só
+    CompressionMode compression = CompressionMode::NONE;  // precisa bater com network.compression
+    int compression_level = 3;
+    std::string compression_dictionary; // arquivo do dicionário (ZSTD_DICT)
+};
+
+// Um cliente simulado
+struct Bot {
+    uint32_t index = 0;
+    ENetPeer* peer = nullptr;
+    bool connected = false;
+    Vector3 position{0.0f, 0.0f, 0.0f};
+    uint32_t last_snapshot = 0;
+    std::vector<uint8_t> rpc_batch;     // RPCs do tick ainda não enviados
+};
+
+class Scenario;
+
+// Abre as conexões, roda o cenário e mede o servidor
+class LoadBot {
+public:
+    explicit LoadBot(const LoadBotOptions& options);
+    ~LoadBot();
+
+    bool initialize();
+    void run(const std::atomic<bool>& running);
+
+    // ========== Envio (usado pelo Scenario) ==========
+    void sendAuth(Bot& bot, std::string_view payload);
+    void sendMove(Bot& bot, const Vector3& position);
+    void sendChat(Bot& bot, std::string_view text);
+    void sendRPC(Bot& bot, uint32_t node_id, uint16_t method_id, const std::vector<Variant>& args);
+
+private:
+    // A ENet limita o número de peers por host; os bots são distribuídos
+    static constexpr size_t kBotsPerHost = 1024;
+    static constexpr size_t kChannelCount = 4;
+
+    // Mesmos canais da ChannelPolicy padrão do servidor
+    static constexpr uint8_t kReliableChannel = 0;
+    static constexpr uint8_t kSequencedChannel = 1;
+    static constexpr uint8_t kUnsequencedChannel = 2;
+
+    using Clock = std::chrono::steady_clock;
+
+    // Acumuladores de um intervalo de relatório
+    struct IntervalStats {
+        std::vector<uint32_t> rtt_samples;
+        uint64_t bytes_in = 0;
+        uint64_t bytes_out = 0;
+        uint64_t packets_in = 0;
+        bool has_server_stats = false;
+        protocol::ServerStats server_begin;
+        protocol::ServerStats server_end;
+    };
+
+    void send(Bot& bot, uint8_t channel, uint32_t flags);
+    void send(Bot& bot, const std::vector<uint8_t>& data, uint8_t channel, uint32_t flags);
+    void flushRPCs(Bot& bot);
+    void connectPending(float elapsed_seconds);
+    void serviceHosts();
+    void handleEvent(const ENetEvent& event);
+    void handleMessage(Bot& bot, PacketType type, const uint8_t* payload, size_t size);
+    void tickBots(float delta_time);
+    void sampleLinks();
+    void requestServerStats();
+    void recordServerStats(const protocol::ServerStats& stats);
+    void report(IntervalStats& stats, float elapsed, const char* label);
+
+    LoadBotOptions options_;
+    ENetAddress server_address_{};
+    std::vector<ENetHost*> hosts_;
+    std::vector<Bot> bots_;
+    std::unique_ptr<Scenario> scenario_;
+
+    size_t next_to_connect_ = 0;
+    size_t connected_count_ = 0;
+    size_t disconnect_count_ = 0;
+    std::vector<uint8_t> scratch_;
+
+    IntervalStats interval_;
+    IntervalStats total_;
+};
@@ -0,0 +1,79 @@
+// tools/loadbot/Protocol.cpp
+#include "Protocol.h"
+#include "server/RPCWire.h"
+#include <cstring>
+
+namespace protocol {
+
+static void begin(std::vector<uint8_t>& out, PacketType type) {
+    out.clear();
+    out.push_back(static_cast<uint8_t>(type));
+}
+
+void encodeAuth(std::vector<uint8_t>& out, std::string_view payload) {
+    begin(out, PacketType::AUTH_REQUEST);
+    out.insert(out.end(), payload.begin(), payload.end());
+}
+
+void encodePlayerMove(std::vector<uint8_t>& out, const Vector3& position) {
+    begin(out, PacketType::PLAYER_MOVE);
+    // O servidor faz memcpy de três floats logo após o tipo
+    float coords[3] = {position.x, position.y, position.z};
+    size_t offset = out.size();
+    out.resize(offset + sizeof(coords));
+    std::memcpy(out.data() + offset, coords, sizeof(coords));
+}
+
+void encodeChat(std::vector<uint8_t>& out, std::string_view text) {
+    begin(out, PacketType::CHAT_MESSAGE);
+    out.insert(out.end(), text.begin(), text.end());
+}
+
+void encodeSnapshotAck(std::vector<uint8_t>& out, uint32_t sequence) {
+    begin(out, PacketType::SNAPSHOT_ACK);
+    BinaryWriter writer(out);
+    writer.writeU32(sequence);
+}
+
+void encodeStatsRequest(std::vector<uint8_t>& out) {
+    begin(out, PacketType::SERVER_STATS);
+}
+
+// =============================================================
+// RPC Godot
+// =============================================================
+bool encodeGodotRPC(std::vector<uint8_t>& out, uint32_t node_id, uint16_t method_id,
+                    const std::vector<Variant>& args) {
+    begin(out, PacketType::NETWORK_COMMAND_REMOTE_CALL);
+    BinaryWriter writer(out);
+    return rpc_wire::writeCall(writer, node_id, method_id, args);
+}
+
+void appendToRPCBatch(std::vector<uint8_t>& batch, const std::vector<uint8_t>& rpc) {
+    if (batch.empty()) {
+        batch.push_back(static_cast<uint8_t>(PacketType::NETWORK_COMMAND_REMOTE_CALL_BATCH));
+    }
+    BinaryWriter writer(batch);
+    writer.writeVarUInt(static_cast<uint32_t>(rpc.size()));
+    writer.writeBytes(rpc.data(), rpc.size());
+}
+
+// =============================================================
+// Respostas
+// =============================================================
+bool decodeServerStats(const uint8_t* data, size_t size, ServerStats& out) {
+    try {
+        BinaryReader reader(data, size);
+        out.avg_frame_ms = reader.readFloat();
+        out.max_frame_ms = reader.readFloat();
+        out.total_frames = reader.readU64();
+        out.connected_players = reader.readU32();
+        out.packets_sent = reader.readU64();
+        out.packets_received = reader.readU64();
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+}
@@ -0,0 +1,58 @@
+// tools/loadbot/Protocol.h
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "server/PacketType.h"
+#include "server/RPCHandler.h"
+
+// Codificação dos pacotes que um cliente real envia, no mesmo formato
+// que o Server e o RPCHandler esperam. Todos começam pelo byte de tipo.
+namespace protocol {
+
+// [AUTH_REQUEST][payload definido pelo script de autenticação]
+void encodeAuth(std::vector<uint8_t>& out, std::string_view payload);
+
+// [PLAYER_MOVE][f32 x][f32 y][f32 z]
+void encodePlayerMove(std::vector<uint8_t>& out, const Vector3& position);
+
+// [CHAT_MESSAGE][texto]
+void encodeChat(std::vector<uint8_t>& out, std::string_view text);
+
+// [SNAPSHOT_ACK][u32 sequence]
+void encodeSnapshotAck(std::vector<uint8_t>& out, uint32_t sequence);
+
+// [SERVER_STATS]
+void encodeStatsRequest(std::vector<uint8_t>& out);
+
+// RPC Godot no formato de RPCHandler::processGodotPacket (ver rpc_wire::writeCall):
+// [0x20][meta][node_id 1/2/4 bytes][method_id 1/2 bytes][u8 argc][variants]
+// false se houver mais de 255 argumentos (nada a enviar)
+bool encodeGodotRPC(std::vector<uint8_t>& out, uint32_t node_id, uint16_t method_id,
+                    const std::vector<Variant>& args);
+
+// Acrescenta um RPC já codificado (encodeGodotRPC) ao frame
+// [0x21]([varuint len][0x20][chamada])...; batch vazio começa o frame
+void appendToRPCBatch(std::vector<uint8_t>& batch, const std::vector<uint8_t>& rpc);
+
+// Resposta de SERVER_STATS (ver Server::processEvents)
+struct ServerStats {
+    float avg_frame_ms = 0.0f;
+    float max_frame_ms = 0.0f;
+    uint64_t total_frames = 0;
+    uint32_t connected_players = 0;
+    uint64_t packets_sent = 0;
+    uint64_t packets_received = 0;
+};
+
+bool decodeServerStats(const uint8_t* data, size_t size, ServerStats& out);
+
+// Chama fn(tipo, payload, tamanho) para cada mensagem do pacote,
+// abrindo o envelope BATCH quando presente. false se malformado.
+template<typename Fn>
+bool forEachMessage(const uint8_t* data, size_t size, Fn&& fn);
+
+}
+
+#include "Protocol.inl"
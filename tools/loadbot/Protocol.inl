@@ -0,0 +1,35 @@
+// tools/loadbot/Protocol.inl
+#pragma once
+
+#include "utils/BinaryStream.h"
+
+namespace protocol {
+
+template<typename Fn>
+bool forEachMessage(const uint8_t* data, size_t size, Fn&& fn) {
+    if (size == 0) {
+        return false;
+    }
+
+    if (data[0] != static_cast<uint8_t>(PacketType::BATCH)) {
+        fn(static_cast<PacketType>(data[0]), data + 1, size - 1);
+        return true;
+    }
+
+    try {
+        BinaryReader reader(data + 1, size - 1);
+        while (!reader.empty()) {
+            uint32_t length = reader.readVarUInt();
+            if (length == 0) {
+                return false;
+            }
+            const uint8_t* message = reader.readBytes(length);
+            fn(static_cast<PacketType>(message[0]), message + 1, static_cast<size_t>(length - 1));
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+}
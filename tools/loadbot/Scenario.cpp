@@ -0,0 +1,98 @@
+// tools/loadbot/Scenario.cpp
+#include "Scenario.h"
+#include "LoadBot.h"
+#include <cmath>
+#include <iostream>
+
+// Converte um argumento Lua para Variant. Números inteiros viram INT,
+// os demais FLOAT; tabelas {x, y, z} viram VECTOR3. Strings são copiadas
+// para a arena, válidas até o próximo reset.
+static Variant toVariant(const sol::object& value, Arena& arena) {
+    switch (value.get_type()) {
+        case sol::type::boolean:
+            return Variant(value.as<bool>());
+        case sol::type::number: {
+            double d = value.as<double>();
+            if (std::floor(d) == d && std::fabs(d) < 9007199254740992.0) {
+                return Variant(static_cast<int64_t>(d));
+            }
+            return Variant(d);
+        }
+        case sol::type::string:
+            return Variant::string(value.as<std::string_view>(), arena);
+        case sol::type::table: {
+            sol::table t = value.as<sol::table>();
+            return Variant(Vector3{t["x"].get_or(0.0f), t["y"].get_or(0.0f), t["z"].get_or(0.0f)});
+        }
+        default:
+            return Variant();
+    }
+}
+
+Scenario::Scenario(LoadBot& loadbot) : loadbot_(loadbot) {
+    lua_.open_libraries(sol::lib::base, sol::lib::math, sol::lib::string, sol::lib::table);
+    bindAPI();
+}
+
+void Scenario::bindAPI() {
+    LoadBot& loadbot = loadbot_;
+    Arena& arena = args_arena_;
+
+    lua_.new_usertype<Bot>("Bot",
+        "id", sol::readonly(&Bot::index),
+        "x", sol::property([](const Bot& bot) { return bot.position.x; }),
+        "y", sol::property([](const Bot& bot) { return bot.position.y; }),
+        "z", sol::property([](const Bot& bot) { return bot.position.z; }),
+        "auth", [&loadbot](Bot& bot, const std::string& payload) { loadbot.sendAuth(bot, payload); },
+        "move", [&loadbot](Bot& bot, float x, float y, float z) { loadbot.sendMove(bot, Vector3{x, y, z}); },
+        "chat", [&loadbot](Bot& bot, const std::string& text) { loadbot.sendChat(bot, text); },
+        "rpc", [&loadbot, &arena](Bot& bot, uint32_t node_id, uint16_t method_id, sol::variadic_args va) {
+            arena.reset();
+            std::vector<Variant> args;
+            args.reserve(va.size());
+            for (const auto& arg : va) {
+                args.push_back(toVariant(arg, arena));
+            }
+            loadbot.sendRPC(bot, node_id, method_id, args);
+        }
+    );
+}
+
+bool Scenario::load(const std::string& path) {
+    try {
+        lua_.script_file(path);
+    } catch (const sol::error& e) {
+        std::cerr << "Failed to load scenario " << path << ": " << e.what() << "\n";
+        return false;
+    }
+
+    on_connect_ = lua_["on_connect"];
+    on_tick_ = lua_["on_tick"];
+    return true;
+}
+
+void Scenario::reportError(const sol::protected_function_result& result) {
+    // Um script quebrado erraria em todo tick de todo bot: loga só os primeiros
+    if (++error_count_ <= 10) {
+        sol::error err = result;
+        std::cerr << "Scenario error: " << err.what() << "\n";
+    }
+}
+
+void Scenario::onConnect(Bot& bot) {
+    if (on_connect_.valid()) {
+        auto result = on_connect_(&bot);
+        if (!result.valid()) {
+            reportError(result);
+        }
+    }
+}
+
+void Scenario::onTick(Bot& bot, float delta_time) {
+    if (on_tick_.valid()) {
+        auto result = on_tick_(&bot, delta_time);
+        if (!result.valid()) {
+            reportError(result);
+        }
+    }
+}
@@ -0,0 +1,35 @@
+// tools/loadbot/Scenario.h
+#pragma once
+
+#include "utils/Arena.h"
+#include <sol/sol.hpp>
+#include <string>
+
+class LoadBot;
+struct Bot;
+
+// Script Lua que dirige os bots. Callbacks opcionais:
+//   on_connect(bot)          logo após conectar (ex.: autenticar)
+//   on_tick(bot, dt)         a cada tick do loadbot
+// Métodos do bot: bot:auth(payload), bot:move(x, y, z), bot:chat(texto),
+// bot:rpc(node_id, method_id, ...). Campos: bot.id, bot.x, bot.y, bot.z.
+class Scenario {
+public:
+    explicit Scenario(LoadBot& loadbot);
+
+    bool load(const std::string& path);
+
+    void onConnect(Bot& bot);
+    void onTick(Bot& bot, float delta_time);
+
+private:
+    void bindAPI();
+    void reportError(const sol::protected_function_result& result);
+
+    LoadBot& loadbot_;
+    Arena args_arena_;          // strings dos argumentos de bot:rpc
+    sol::state lua_;
+    sol::protected_function on_connect_;
+    sol::protected_function on_tick_;
+    size_t error_count_ = 0;
+};
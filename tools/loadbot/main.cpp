@@ -0,0 +1,98 @@
+// tools/loadbot/main.cpp
+#include "LoadBot.h"
+#include <magic_enum/magic_enum.hpp>
+#include <atomic>
+#include <csignal>
+#include <iostream>
+#include <string>
+
+static std::atomic<bool> g_running{true};
+
+static void signalHandler(int) {
+    g_running = false;
+}
+
+int main(int argc, char* argv[]) {
+    LoadBotOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "--host" && i + 1 < argc) {
+            options.host = argv[++i];
+        } else if (arg == "--port" && i + 1 < argc) {
+            options.port = static_cast<uint16_t>(std::stoi(argv[++i]));
+        } else if (arg == "--clients" && i + 1 < argc) {
+            options.clients = std::stoull(argv[++i]);
+        } else if (arg == "--connect-rate" && i + 1 < argc) {
+            options.connect_rate = std::stoull(argv[++i]);
+        } else if (arg == "--duration" && i + 1 < argc) {
+            options.duration_seconds = std::stof(argv[++i]);
+        } else if (arg == "--tick-rate" && i + 1 < argc) {
+            options.tick_rate = std::stof(argv[++i]);
+        } else if (arg == "--report" && i + 1 < argc) {
+            options.report_interval = std::stof(argv[++i]);
+        } else if (arg == "--script" && i + 1 < argc) {
+            options.script = argv[++i];
+        } else if (arg == "--batch-rpcs") {
+            options.batch_rpcs = true;
+        } else if (arg == "--compress" && i + 1 < argc) {
+            std::string name = argv[++i];
+            auto mode = magic_enum::enum_cast<CompressionMode>(name);
+            if (!mode) {
+                std::cerr << "Unknown compression mode: " << name << "\n";
+                return 1;
+            }
+            options.compression = *mode;
+        } else if (arg == "--compress-level" && i + 1 < argc) {
+            options.compression_level = std::stoi(argv[++i]);
+        } else if (arg == "--compress-dictionary" && i + 1 < argc) {
+            options.compression_dictionary = argv[++i];
+        } else if (arg == "--help") {
+            std::cout << "Usage: " << argv[0] << " [options]\n"
+                      << "Options:\n"
+                      << "  --host <addr>           Server address (default: 127.0.0.1)\n"
+                      << "  --port <port>           Server port (default: 7777)\n"
+                      << "  --clients <num>         Simulated clients (default: 100)\n"
+                      << "  --connect-rate <num>    New connections per second (default: 200)\n"
+                      << "  --duration <seconds>    Run time, 0 = until Ctrl+C (default: 60)\n"
+                      << "  --tick-rate <hz>        Scenario on_tick rate (default: 20)\n"
+                      << "  --report <seconds>      Report interval (default: 5)\n"
+                      << "  --script <file>         Lua scenario (default: scenarios/walk.lua)\n"
+                      << "  --batch-rpcs            Send each bot's RPCs of a tick in one batch frame\n"
+                      << "  --compress <mode>       ENet compression: NONE, RANGE_CODER, ZSTD, ZSTD_DICT\n"
+                      << "                          (must match the server's network.compression)\n"
+                      << "  --compress-level <n>    zstd level (default: 3)\n"
+                      << "  --compress-dictionary <file>  zstd dictionary for ZSTD_DICT\n"
+                      << "  --help                  Show this help\n"
+                      << "\nServer tick times require network.stats_requests = true on the server.\n";
+            return 0;
+        }
+    }
+
+    if (options.clients == 0 || options.tick_rate <= 0.0f) {
+        std::cerr << "--clients and --tick-rate must be positive\n";
+        return 1;
+    }
+
+    if (enet_initialize() != 0) {
+        std::cerr << "Failed to initialize ENet\n";
+        return 1;
+    }
+
+    std::signal(SIGINT, signalHandler);
+    std::signal(SIGTERM, signalHandler);
+
+    int exit_code = 0;
+    {
+        LoadBot loadbot(options);
+        if (loadbot.initialize()) {
+            loadbot.run(g_running);
+        } else {
+            exit_code = 1;
+        }
+    }
+
+    enet_deinitialize();
+    return exit_code;
+}
@@ -0,0 +1,41 @@
+-- scenarios/walk.lua
+-- Cada bot autentica, anda em círculo em volta de um ponto aleatório,
+-- manda chat de vez em quando e chama um RPC Godot.
+
+local AREA = 500.0        -- lado da área onde os bots nascem
+local SPEED = 5.0         -- unidades por segundo
+local CHAT_CHANCE = 0.002 -- por tick
+local RPC_CHANCE = 0.01   -- por tick
+
+local state = {}
+
+function on_connect(bot)
+    -- O formato do payload é definido por handle_auth_request no servidor
+    bot:auth("bot" .. bot.id)
+
+    state[bot.id] = {
+        cx = math.random() * AREA,
+        cz = math.random() * AREA,
+        radius = 10.0 + math.random() * 40.0,
+        angle = math.random() * 2.0 * math.pi,
+    }
+end
+
+function on_tick(bot, dt)
+    local s = state[bot.id]
+    if s == nil then
+        return
+    end
+
+    s.angle = s.angle + (SPEED / s.radius) * dt
+    bot:move(s.cx + math.cos(s.angle) * s.radius, 0.0, s.cz + math.sin(s.angle) * s.radius)
+
+    if math.random() < CHAT_CHANCE then
+        bot:chat("hello from bot" .. bot.id)
+    end
+
+    if math.random() < RPC_CHANCE then
+        -- node 1, método 0, com argumentos de vários tipos
+        bot:rpc(1, 0, 42, 1.5, true, "ping", { x = bot.x, y = bot.y, z = bot.z })
+    end
+end